@@ -0,0 +1,143 @@
+#pragma once
+#include "Helpers.h"
+
+#include <array>
+
+// ================== Staza napravljena pri kompajliranju ==================
+// Za fiksni raspored kontrolnih tacaka cela staza (tacke, tangente, duzine luka)
+// moze da se izracuna constexpr i ugradi u program - pri pokretanju nema nikakvog racunanja.
+
+// Kriva se racuna istim constexpr funkcijama raspona kao i buildTrack (Helpers.h),
+// ovde je samo koren, jer std::sqrt nije constexpr.
+
+// std::sqrt nije constexpr - Njutnova metoda (u double, pa zaokruzeno na float)
+constexpr float constexprSqrt(float v)
+{
+    if (v <= 0.0f) return 0.0f;
+
+    double x = (v > 1.0f) ? (double)v : 1.0;
+    for (int i = 0; i < 100; ++i) {
+        double next = 0.5 * (x + (double)v / x);
+        if (next == x) break;
+        x = next;
+    }
+    return (float)x;
+}
+
+// koliko finija je tabela ravnomernih duzina od same putanje (isto kao u Helpres.cpp)
+constexpr int BAKED_ARC_RESOLUTION = 4;
+
+template <int SEGMENTS>
+struct BakedTrack {
+    static constexpr int count = SEGMENTS;
+    static constexpr int arcTableSize = (SEGMENTS - 1) * BAKED_ARC_RESOLUTION;
+
+    // poravnato kao i TrackBuffer, da SIMD petlje mogu direktno da citaju
+    alignas(32) std::array<float, SEGMENTS> x{};
+    alignas(32) std::array<float, SEGMENTS> y{};
+    alignas(32) std::array<float, SEGMENTS> tx{};
+    alignas(32) std::array<float, SEGMENTS> ty{};
+    alignas(32) std::array<float, SEGMENTS> curvature{};
+    alignas(32) std::array<float, SEGMENTS> arcLen{};
+    alignas(32) std::array<float, arcTableSize + 1> arcT{};
+    float totalLength = 0.0f;
+};
+
+// Isto kao buildTrack + buildArcLength (sa tangentama i zakrivljenoscu), ali constexpr
+template <int SEGMENTS, std::size_t NUM_CTRL>
+constexpr BakedTrack<SEGMENTS> bakeTrack(const std::array<Vec2, NUM_CTRL>& ctrlPoints)
+{
+    static_assert(SEGMENTS >= 2, "staza mora imati bar dve tacke");
+    constexpr int numCtrl = (int)NUM_CTRL;
+
+    BakedTrack<SEGMENTS> track{};
+
+    // koeficijenti svih raspona, kao buildTrackSpline
+    std::array<SpanCoeffs, NUM_CTRL> spans{};
+    for (int k = 0; k < numCtrl; ++k)
+        spans[k] = catmullRomCoeffs(ctrlPoints[(k - 1 + numCtrl) % numCtrl], ctrlPoints[k],
+            ctrlPoints[(k + 1) % numCtrl], ctrlPoints[(k + 2) % numCtrl], TRACK_SCALE_X);
+
+    for (int i = 0; i < SEGMENTS - 1; ++i) {       //  poslednja tacka = prva, dole
+        float u = (float)i / (float)(SEGMENTS - 1);
+        float s = u * numCtrl;
+        int seg = (int)s;                           // s >= 0, pa je (int) isto sto i floor
+        if (seg > numCtrl - 1) seg = numCtrl - 1;
+        float t = s - (float)seg;
+        const SpanCoeffs& c = spans[seg];
+
+        Vec2 p = spanPoint(c, t);
+        track.x[i] = p.x;
+        track.y[i] = p.y;
+
+        Vec2 d = spanDerivative(c, t);
+        float len = constexprSqrt(d.x * d.x + d.y * d.y);
+        track.curvature[i] = spanCurvatureOf(d, spanSecondDerivative(c, t), len);
+
+        if (len > 0.0f) {
+            d.x /= len;
+            d.y /= len;
+        }
+        track.tx[i] = d.x;
+        track.ty[i] = d.y;
+    }
+
+    //zatvaranje staze
+    track.x[SEGMENTS - 1] = track.x[0];
+    track.y[SEGMENTS - 1] = track.y[0];
+    track.tx[SEGMENTS - 1] = track.tx[0];
+    track.ty[SEGMENTS - 1] = track.ty[0];
+    track.curvature[SEGMENTS - 1] = track.curvature[0];
+
+    // kumulativne duzine
+    track.arcLen[0] = 0.0f;
+    for (int i = 1; i < SEGMENTS; ++i) {
+        float dx = track.x[i] - track.x[i - 1];
+        float dy = track.y[i] - track.y[i - 1];
+        track.arcLen[i] = track.arcLen[i - 1] + constexprSqrt(dx * dx + dy * dy);
+    }
+    track.totalLength = track.arcLen[SEGMENTS - 1];
+
+    // obrnuta tabela duzina -> t
+    constexpr int tableSize = BakedTrack<SEGMENTS>::arcTableSize;
+    int seg = 0;
+    for (int k = 0; k <= tableSize; ++k) {
+        float s = track.totalLength * (float)k / (float)tableSize;
+        while (seg < SEGMENTS - 2 && track.arcLen[seg + 1] < s)
+            ++seg;
+
+        float segLen = track.arcLen[seg + 1] - track.arcLen[seg];
+        float alpha = (segLen > 0.0f) ? (s - track.arcLen[seg]) / segLen : 0.0f;
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (alpha > 1.0f) alpha = 1.0f;
+
+        track.arcT[k] = ((float)seg + alpha) / (float)(SEGMENTS - 1);
+    }
+
+    return track;
+}
+
+// Pozicija na sini za t u [0,1] - constexpr, pa se za konstantno t svodi na konstantu
+template <int SEGMENTS>
+constexpr Vec2 sampleBakedTrack(const BakedTrack<SEGMENTS>& track, float t)
+{
+    if (t <= 0.0f) return { track.x[0], track.y[0] };
+    if (t >= 1.0f) return { track.x[SEGMENTS - 1], track.y[SEGMENTS - 1] };
+
+    float fIndex = t * (float)(SEGMENTS - 1);
+    int   i0 = (int)fIndex;
+    float alpha = fIndex - (float)i0;
+    return { track.x[i0] + (track.x[i0 + 1] - track.x[i0]) * alpha,
+             track.y[i0] + (track.y[i0 + 1] - track.y[i0]) * alpha };
+}
+
+// TrackBuffer koji samo pokazuje na ugradjene nizove (nista se ne kopira ni ne alocira)
+template <int SEGMENTS>
+void attachBakedTrack(TrackBuffer& track, const BakedTrack<SEGMENTS>& baked)
+{
+    attachTrackView(track, SEGMENTS, baked.x.data(), baked.y.data(),
+        baked.tx.data(), baked.ty.data(),
+        baked.arcLen.data(), baked.arcT.data(), BakedTrack<SEGMENTS>::arcTableSize,
+        baked.totalLength);
+    track.curvature = const_cast<float*>(baked.curvature.data());
+}
@@ -1,18 +1,228 @@
 #pragma once
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
+#include <vector>
 
 struct Vec2 {
     float x, y;
 };
 
-static Vec2 catmullRom(float t, const Vec2& p0, const Vec2& p1, const Vec2& p2, const Vec2& p3);
+// staza je malo suzena po x u odnosu na kontrolne tacke
+const float TRACK_SCALE_X = 0.7f;
 
-// Pravi celu putanju
-void buildTrack(Vec2* trackPoints, int trackSegments, const Vec2* ctrlPoints, int numCtrl);
+// Pozicija + jedinicna tangenta + normala u jednoj tacki putanje
+struct TrackFrame {
+    Vec2 pos;
+    Vec2 tangent;   // smer kretanja
+    Vec2 normal;    // tangenta rotirana za +90 stepeni
+};
+
+// Koeficijenti kubnog polinoma jednog Catmull-Rom raspona (izmedju dve kontrolne tacke):
+// p(t) = a + b*t + c*t^2 + d*t^3, t u [0,1)
+struct SpanCoeffs {
+    float ax, bx, cx, dx;
+    float ay, by, cy, dy;
+};
+
+// Funkcije raspona su constexpr - iste racuna i ugradjena staza (BakedTrack.h) pri kompajliranju.
+
+// Koeficijenti raspona p1-p2 (p0 i p3 su susedi); x se odmah mnozi sa scaleX
+constexpr SpanCoeffs catmullRomCoeffs(const Vec2& p0, const Vec2& p1, const Vec2& p2, const Vec2& p3, float scaleX)
+{
+    // isti polinom kao u Catmull-Rom formuli, samo sredjen po stepenima t
+    SpanCoeffs c{};
+    c.ax = scaleX * 0.5f * (2.0f * p1.x);
+    c.bx = scaleX * 0.5f * (-p0.x + p2.x);
+    c.cx = scaleX * 0.5f * (2.0f * p0.x - 5.0f * p1.x + 4.0f * p2.x - p3.x);
+    c.dx = scaleX * 0.5f * (-p0.x + 3.0f * p1.x - 3.0f * p2.x + p3.x);
+
+    c.ay = 0.5f * (2.0f * p1.y);
+    c.by = 0.5f * (-p0.y + p2.y);
+    c.cy = 0.5f * (2.0f * p0.y - 5.0f * p1.y + 4.0f * p2.y - p3.y);
+    c.dy = 0.5f * (-p0.y + 3.0f * p1.y - 3.0f * p2.y + p3.y);
+    return c;
+}
+
+// Tacka raspona za jedno t (Horner, isti redosled operacija kao u SIMD petljama)
+constexpr Vec2 spanPoint(const SpanCoeffs& c, float t)
+{
+    return { c.ax + t * (c.bx + t * (c.cx + t * c.dx)),
+             c.ay + t * (c.by + t * (c.cy + t * c.dy)) };
+}
+
+// Izvod raspona po t (nije normalizovan)
+constexpr Vec2 spanDerivative(const SpanCoeffs& c, float t)
+{
+    return { c.bx + t * (2.0f * c.cx + t * (3.0f * c.dx)),
+             c.by + t * (2.0f * c.cy + t * (3.0f * c.dy)) };
+}
+
+// Drugi izvod raspona po t
+constexpr Vec2 spanSecondDerivative(const SpanCoeffs& c, float t)
+{
+    return { 2.0f * c.cx + t * (6.0f * c.dx),
+             2.0f * c.cy + t * (6.0f * c.dy) };
+}
+
+// Zakrivljenost iz izvoda: (x'y'' - y'x'') / |p'|^3, len = |p'| (koren racuna pozivalac)
+constexpr float spanCurvatureOf(Vec2 d1, Vec2 d2, float len)
+{
+    return (len > 0.0f) ? (d1.x * d2.y - d1.y * d2.x) / (len * len * len) : 0.0f;
+}
+
+// Koeficijenti svih raspona zatvorene staze - racunaju se jednom, kad se promene kontrolne tacke,
+// pa svaki upit za poziciju/pravac na krivoj je samo par mnozenja i sabiranja (Horner)
+struct TrackSpline {
+    int numCtrl = 0;                  // broj raspona (kod zatvorene staze = broj kontrolnih tacaka)
+    std::vector<SpanCoeffs> spans;    // raspon i ide od kontrolne tacke i do i+1
+    bool closed = true;               // false: otvorena kriva (npr. ivica grafa), kraj nije pocetak
+};
+
+// Najmanje kontrolnih tacaka za zatvorenu stazu - isto za ugradjen, ucitan i generisan raspored
+const int MIN_TRACK_CTRL = 3;
+
+// Koeficijenti za sve raspone (x je vec skaliran kao u buildTrack).
+// false (i prazna kriva) ako ima manje od MIN_TRACK_CTRL tacaka.
+bool buildTrackSpline(TrackSpline& spline, const Vec2* ctrlPoints, int numCtrl);
+
+// Otvorena kriva kroz numPoints tacaka (numPoints - 1 raspona). before/after su susedi pre prve
+// i posle poslednje tacke (npr. sa susedne ivice, da spoj bude gladak); nullptr = odraz druge tacke.
+void buildOpenTrackSpline(TrackSpline& spline, const Vec2* points, int numPoints,
+    const Vec2* before, const Vec2* after);
+
+// Isto, ali tacku po tacku (npr. dok se fajl cita) - ne treba niz svih kontrolnih tacaka.
+// Raspon i je gotov cim stigne tacka i+2; za zatvaranje petlje se pamte prve tri tacke.
+struct TrackSplineStream {
+    TrackSpline* spline = nullptr;
+    Vec2 head[3];       // prve tri tacke
+    Vec2 window[3];     // poslednje tri primljene
+    int  received = 0;
+};
+
+void beginTrackSpline(TrackSplineStream& stream, TrackSpline& spline);
+void addTrackSplinePoint(TrackSplineStream& stream, Vec2 p);
+bool endTrackSpline(TrackSplineStream& stream);    // false ako je stiglo manje od MIN_TRACK_CTRL tacaka
+
+// Mesto na krivoj: raspon i lokalno t u njemu. Odvojeno, jer u jednom float-u (raspon + t, ili
+// u u [0,1]) posle 2^23 raspona za t ne ostane nijedan bit pa se sve lepi za kontrolne tacke.
+struct SplinePos {
+    int   span = 0;
+    float t = 0.0f;     // u [0,1]
+};
+
+// Tacka na krivoj, bez poligonalne linije izmedju
+Vec2 splinePoint(const TrackSpline& spline, SplinePos pos);
+
+// Pozicija + jedinicna tangenta + normala direktno sa krive
+TrackFrame splineFrame(const TrackSpline& spline, SplinePos pos);
+
+// Zakrivljenost krive (1/poluprecnik, > 0 kad skrece levo)
+float splineCurvature(const TrackSpline& spline, SplinePos pos);
+
+// Staza kao "struktura nizova" (SoA): x[], y[], tangente i duzine luka su posebni nizovi,
+// poravnati na 32 bajta, pa SIMD petlje citaju/pisu ceo registar odjednom.
+// Velicina se zadaje pri pokretanju (allocateTrack), ne pri kompajliranju.
+struct TrackBuffer {
+    int    count = 0;           // broj tacaka (poslednja = prva, staza je zatvorena)
+    float* x = nullptr;
+    float* y = nullptr;
+    float* tx = nullptr;        // jedinicna tangenta (opciono)
+    float* ty = nullptr;
+    float* arcLen = nullptr;    // duzina od pocetka do tacke i (opciono)
+    float* arcT = nullptr;      // t (po indeksu) za ravnomerno rasporedjene duzine, arcTableSize + 1 vrednosti
+    int*   span = nullptr;      // raspon krive u kome je tacka i (opciono, TRACK_PARAM)
+    float* spanT = nullptr;     // lokalno t tacke i u tom rasponu, u [0,1] (uz span)
+    float* curvature = nullptr; // zakrivljenost u tacki i (1/poluprecnik, > 0 kad skrece levo) (opciono)
+    int    arcTableSize = 0;
+    float  totalLength = 0.0f;
+    float  tolerance = 0.0f;    // > 0 ako je staza podeljena adaptivno (buildTrackAdaptive)
+
+    void*  storage = nullptr;   // memorija koju ovaj bafer drzi (nullptr ako nizovi pokazuju na tudju)
+
+    TrackBuffer() = default;
+    ~TrackBuffer();
+    TrackBuffer(TrackBuffer&& other) noexcept;
+    TrackBuffer& operator=(TrackBuffer&& other) noexcept;
+    TrackBuffer(const TrackBuffer&) = delete;
+    TrackBuffer& operator=(const TrackBuffer&) = delete;
+
+    bool hasTangents() const { return tx != nullptr; }
+    bool hasArcLength() const { return arcLen != nullptr; }
+    bool hasParam() const { return span != nullptr; }
+    bool hasCurvature() const { return curvature != nullptr; }
+};
+
+// sta se jos pravi uz pozicije
+enum TrackBufferFlags {
+    TRACK_TANGENTS = 1 << 0,
+    TRACK_ARC_LENGTH = 1 << 1,
+    TRACK_PARAM = 1 << 2,
+    TRACK_CURVATURE = 1 << 3
+};
+
+// Rezervise nizove za "count" tacaka; stari sadrzaj se brise
+bool allocateTrack(TrackBuffer& track, int count, int flags);
+void freeTrack(TrackBuffer& track);
+
+// Deo staze [first, last) koji se promenio
+struct TrackRange {
+    int first = 0;
+    int last = 0;
+};
+
+// Sta je updateControlPoint promenio - samo ti delovi idu ponovo na GPU
+struct TrackUpdate {
+    TrackRange ranges[3];
+    int  numRanges = 0;
+    bool resized = false;   // promenio se broj tacaka - ceo bafer ispocetka
+};
+
+// Bafer koji samo pokazuje na tudje nizove (ugradjena staza, mapiran fajl...).
+// Takav bafer se samo cita - ne sme se prosledjivati buildTrack-u. Bilo koji opcioni niz moze biti nullptr.
+void attachTrackView(TrackBuffer& track, int count, const float* x, const float* y,
+    const float* tx, const float* ty, const float* arcLen, const float* arcT, int arcTableSize,
+    float totalLength);
+
+// Pravi celu putanju u vec rezervisan bafer. Tangente i zakrivljenost (tacno iz Catmull-Rom izvoda)
+// i duzine luka se racunaju ako bafer ima mesta za njih.
+// numThreads > 1 deli raspone (i duzine luka) na niti; 0 = sva jezgra. Rezultat je isti bit za bit.
+void buildTrack(TrackBuffer& track, const Vec2* ctrlPoints, int numCtrl);
+void buildTrack(TrackBuffer& track, const TrackSpline& spline, int numThreads = 1);   // iz vec izracunatih koeficijenata
+
+// Adaptivna podela: svaki raspon se deli dok tetiva ne odstupa od krive vise od "tolerance".
+// Broj tacaka zavisi od krivine, pa funkcija sama rezervise bafer (flags kao za allocateTrack).
+// Sa TRACK_PARAM se pamti i mesto na krivoj (raspon, t) za svaku tacku.
+bool buildTrackAdaptive(TrackBuffer& track, const Vec2* ctrlPoints, int numCtrl, float tolerance, int flags);
+bool buildTrackAdaptive(TrackBuffer& track, const TrackSpline& spline, float tolerance, int flags, int numThreads = 1);
 
 // Uzorak jedne tacke sa putanje
-Vec2 sampleTrack(float t, const Vec2* trackPoints, int trackSegments);
+Vec2 sampleTrack(float t, const TrackBuffer& track);
 
 // Ugao tangente na putanji
-float trackAngle(float t, const Vec2* trackPoints, int trackSegments);
\ No newline at end of file
+float trackAngle(float t, const TrackBuffer& track);
+
+// Uzorak pozicije i pravca iz tabela koje je napravio buildTrack (bez sin/cos/atan2)
+TrackFrame sampleTrackFrame(float t, const TrackBuffer& track);
+
+// Kopija staze u sopstvenu memoriju (npr. pre izmene staze koja je samo pogled na tudje nizove)
+bool copyTrack(TrackBuffer& dst, const TrackBuffer& src);
+
+// Pravi tabelu duzina luka za vec napravljenu putanju (buildTrack je sam poziva)
+void buildArcLength(TrackBuffer& track, int numThreads = 1);
+
+// Pomera jednu kontrolnu tacku i menja samo 4 raspona koja od nje zavise.
+// Duzine luka se racunaju ponovo tek od prve promenjene tacke. Adaptivnoj stazi
+// tacke ostaju na istim (raspon, t), pa se broj tacaka ne menja; novu podelu
+// napravi retessellateTrack kad se tacka pusti. Bez TRACK_PARAM se pravi ispocetka (resized = true).
+TrackUpdate updateControlPoint(TrackBuffer& track, TrackSpline& spline, Vec2* ctrlPoints, int index, Vec2 newPos);
+
+// Adaptivna staza ponovo podeljena po svojoj toleranciji (posle pomeranja tacaka); false ako nije adaptivna
+bool retessellateTrack(TrackBuffer& track, const TrackSpline& spline, int numThreads = 1);
+
+// Predjeni put s (u jedinicama) -> parametar t za sampleTrack / trackAngle, O(1)
+float arcLengthToT(float s, const TrackBuffer& track);
+
+// Pozicija na sini na predjenom putu s
+Vec2 sampleTrackAtDistance(float s, const TrackBuffer& track);
+
+// t tacke na putanji (kao za sampleTrack) -> mesto na krivoj za splinePoint / splineFrame.
+// Ravnomernoj stazi je t vec parametar krive; adaptivnoj trebaju nizovi span / spanT (TRACK_PARAM).
+SplinePos trackTToSplinePos(float t, const TrackBuffer& track, int numCtrl);
\ No newline at end of file
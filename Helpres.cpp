@@ -1,89 +1,955 @@
 #include "Helpers.h"
+#include "TrackSimd.h"
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
 
-// Catmull-Rom interpolacija izmedju p0,p1,p2,p3  - glatka kriva za tacke za prugu
-static Vec2 catmullRom(float t, const Vec2& p0, const Vec2& p1, const Vec2& p2, const Vec2& p3)
+// ================== Paralelni rad ==================
+// [0, n) se deli na uzastopne delove, po jedan za svaku nit; body(begin, end).
+// Poslednji deo radi pozivajuca nit. Delovi ne zavise od broja niti kad je on 1.
+template <typename Body>
+static void parallelFor(int n, int numThreads, Body body)
 {
-    float t2 = t * t;
-    float t3 = t2 * t;
+    if (numThreads <= 0) numThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, n);
+    if (numThreads <= 1) {
+        if (n > 0) body(0, n);
+        return;
+    }
 
-    Vec2 r;
-    r.x = 0.5f * ((2.0f * p1.x) +
-        (-p0.x + p2.x) * t +
-        (2.0f * p0.x - 5.0f * p1.x + 4.0f * p2.x - p3.x) * t2 +
-        (-p0.x + 3.0f * p1.x - 3.0f * p2.x + p3.x) * t3);
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads - 1);
+    for (int k = 0; k < numThreads - 1; ++k)
+        workers.emplace_back(body, (int)((long long)n * k / numThreads), (int)((long long)n * (k + 1) / numThreads));
+    body((int)((long long)n * (numThreads - 1) / numThreads), n);
+    for (std::thread& w : workers)
+        w.join();
+}
 
-    r.y = 0.5f * ((2.0f * p1.y) +
-        (-p0.y + p2.y) * t +
-        (2.0f * p0.y - 5.0f * p1.y + 4.0f * p2.y - p3.y) * t2 +
-        (-p0.y + 3.0f * p1.y - 3.0f * p2.y + p3.y) * t3);
-    return r;
+static Vec2 normalize(Vec2 v)
+{
+    float len = std::sqrt(v.x * v.x + v.y * v.y);
+    if (len > 0.0f) {
+        v.x /= len;
+        v.y /= len;
+    }
+    return v;
 }
 
 
-// ================== Pravljenje putanje (sine) ==================
-void buildTrack(Vec2* trackPoints, int TRACK_SEGMENTS, const Vec2* ctrlPoints, int NUM_CTRL)    // prvi deo ravan, posle talasi
+// ================== Memorija za stazu ==================
+static const size_t TRACK_ALIGN = 32;                  // AVX registar
+static const int    TRACK_ALIGN_FLOATS = TRACK_ALIGN / sizeof(float);
+
+// koliko finija je tabela ravnomernih duzina od same putanje
+static const int ARC_TABLE_RESOLUTION = 4;
+
+static void* alignedAlloc(size_t bytes)
+{
+#if defined(_MSC_VER)
+    return _aligned_malloc(bytes, TRACK_ALIGN);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, TRACK_ALIGN, bytes) != 0) return nullptr;
+    return p;
+#endif
+}
+
+static void alignedFree(void* p)
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// zaokruzi broj float-ova tako da sledeci niz opet pocne poravnat
+static size_t paddedFloats(int n)
+{
+    return ((size_t)n + TRACK_ALIGN_FLOATS - 1) / TRACK_ALIGN_FLOATS * TRACK_ALIGN_FLOATS;
+}
+
+TrackBuffer::~TrackBuffer()
+{
+    freeTrack(*this);
+}
+
+TrackBuffer::TrackBuffer(TrackBuffer&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+TrackBuffer& TrackBuffer::operator=(TrackBuffer&& other) noexcept
+{
+    if (this != &other) {
+        freeTrack(*this);
+        count = other.count;
+        x = other.x;
+        y = other.y;
+        tx = other.tx;
+        ty = other.ty;
+        arcLen = other.arcLen;
+        arcT = other.arcT;
+        span = other.span;
+        spanT = other.spanT;
+        curvature = other.curvature;
+        arcTableSize = other.arcTableSize;
+        totalLength = other.totalLength;
+        tolerance = other.tolerance;
+        storage = other.storage;
+
+        other.storage = nullptr;
+        freeTrack(other);
+    }
+    return *this;
+}
+
+bool allocateTrack(TrackBuffer& track, int count, int flags)
+{
+    freeTrack(track);
+    if (count < 2) return false;
+
+    size_t perArray = paddedFloats(count);
+    int arcTableSize = (count - 1) * ARC_TABLE_RESOLUTION;
+
+    size_t total = perArray * 2;                               // x, y
+    if (flags & TRACK_TANGENTS)   total += perArray * 2;       // tx, ty
+    if (flags & TRACK_ARC_LENGTH) total += perArray + paddedFloats(arcTableSize + 1);
+    if (flags & TRACK_PARAM)      total += perArray * 2;       // span (int), spanT
+    if (flags & TRACK_CURVATURE)  total += perArray;
+
+    float* block = (float*)alignedAlloc(total * sizeof(float));
+    if (!block) {
+        std::cout << "Nema memorije za stazu od " << count << " tacaka.\n";
+        return false;
+    }
+
+    track.storage = block;
+    track.count = count;
+
+    track.x = block;  block += perArray;
+    track.y = block;  block += perArray;
+    if (flags & TRACK_TANGENTS) {
+        track.tx = block;  block += perArray;
+        track.ty = block;  block += perArray;
+    }
+    if (flags & TRACK_ARC_LENGTH) {
+        track.arcLen = block;  block += perArray;
+        track.arcT = block;  block += paddedFloats(arcTableSize + 1);
+        track.arcTableSize = arcTableSize;
+    }
+    if (flags & TRACK_PARAM) {
+        static_assert(sizeof(int) == sizeof(float), "span deli blok sa float nizovima");
+        track.span = (int*)block;  block += perArray;
+        track.spanT = block;  block += perArray;
+    }
+    if (flags & TRACK_CURVATURE) {
+        track.curvature = block;
+    }
+    return true;
+}
+
+void freeTrack(TrackBuffer& track)
+{
+    if (track.storage) alignedFree(track.storage);
+
+    track.storage = nullptr;
+    track.count = 0;
+    track.x = track.y = nullptr;
+    track.tx = track.ty = nullptr;
+    track.arcLen = track.arcT = nullptr;
+    track.span = nullptr;
+    track.spanT = track.curvature = nullptr;
+    track.arcTableSize = 0;
+    track.totalLength = 0.0f;
+    track.tolerance = 0.0f;
+}
+
+void attachTrackView(TrackBuffer& track, int count, const float* x, const float* y,
+    const float* tx, const float* ty, const float* arcLen, const float* arcT, int arcTableSize,
+    float totalLength)
 {
-    for (int i = 0; i < TRACK_SEGMENTS; ++i) {        //  staza je zatvorena (poslednja tacka = prva)
-        float u = (float)i / (float)(TRACK_SEGMENTS - 1);   // ide od [0,1)
+    freeTrack(track);
+
+    // pokazivaci u TrackBuffer nisu const zbog buildTrack-a, ali ovaj bafer se samo cita
+    track.count = count;
+    track.x = const_cast<float*>(x);
+    track.y = const_cast<float*>(y);
+    track.tx = const_cast<float*>(tx);
+    track.ty = const_cast<float*>(ty);
+    track.arcLen = const_cast<float*>(arcLen);
+    track.arcT = const_cast<float*>(arcT);
+    track.arcTableSize = arcT ? arcTableSize : 0;
+    track.totalLength = totalLength;
+}
+
 
-        // koliko segmenata imamo
-        float s = u * NUM_CTRL;
-        int seg = (int)std::floor(s);
-        float t = s - (float)seg;
+// ================== Koeficijenti krive ==================
+bool buildTrackSpline(TrackSpline& spline, const Vec2* ctrlPoints, int NUM_CTRL)
+{
+    spline.closed = true;
+    if (NUM_CTRL < MIN_TRACK_CTRL) {
+        spline.numCtrl = 0;
+        spline.spans.clear();
+        return false;
+    }
+    spline.numCtrl = NUM_CTRL;
+    spline.spans.resize(NUM_CTRL);
 
+    for (int seg = 0; seg < NUM_CTRL; ++seg) {
         // wrap-around indeksi (zatvorena staza)
         int i0 = (seg - 1 + NUM_CTRL) % NUM_CTRL;
         int i1 = (seg + 0) % NUM_CTRL;
         int i2 = (seg + 1) % NUM_CTRL;
         int i3 = (seg + 2) % NUM_CTRL;
 
-        trackPoints[i] = catmullRom(t,
+        spline.spans[seg] = catmullRomCoeffs(
             ctrlPoints[i0], ctrlPoints[i1],
-            ctrlPoints[i2], ctrlPoints[i3]);
+            ctrlPoints[i2], ctrlPoints[i3], TRACK_SCALE_X);
+    }
+    return true;
+}
+
+void buildOpenTrackSpline(TrackSpline& spline, const Vec2* points, int numPoints,
+    const Vec2* before, const Vec2* after)
+{
+    const int numSpans = numPoints - 1;
+    spline.numCtrl = numSpans > 0 ? numSpans : 0;
+    spline.spans.resize(spline.numCtrl);
+    spline.closed = false;
+    if (numSpans <= 0) return;
+
+    // tacke pre prve i posle poslednje - zadate ili odraz (kraj bez krivine)
+    const Vec2 first = before ? *before : Vec2{ 2.0f * points[0].x - points[1].x, 2.0f * points[0].y - points[1].y };
+    const Vec2 last = after ? *after
+        : Vec2{ 2.0f * points[numSpans].x - points[numSpans - 1].x, 2.0f * points[numSpans].y - points[numSpans - 1].y };
+
+    for (int seg = 0; seg < numSpans; ++seg) {
+        const Vec2& p0 = (seg > 0) ? points[seg - 1] : first;
+        const Vec2& p3 = (seg + 2 <= numSpans) ? points[seg + 2] : last;
+        spline.spans[seg] = catmullRomCoeffs(p0, points[seg], points[seg + 1], p3, TRACK_SCALE_X);
+    }
+}
+
+void beginTrackSpline(TrackSplineStream& stream, TrackSpline& spline)
+{
+    stream.spline = &spline;
+    stream.received = 0;
+    spline.numCtrl = 0;
+    spline.closed = true;
+    spline.spans.clear();
+    spline.spans.push_back(SpanCoeffs{});   // raspon 0 zavisi od poslednje tacke - popunjava se na kraju
+}
+
+void addTrackSplinePoint(TrackSplineStream& stream, Vec2 p)
+{
+    const int k = stream.received++;
+    if (k < 3) stream.head[k] = p;
+
+    // stigla tacka k -> raspon k-2 (tacke k-3 .. k)
+    if (k >= 3)
+        stream.spline->spans.push_back(catmullRomCoeffs(
+            stream.window[0], stream.window[1], stream.window[2], p, TRACK_SCALE_X));
 
-        trackPoints[i].x *= 0.7f;
+    stream.window[0] = stream.window[1];
+    stream.window[1] = stream.window[2];
+    stream.window[2] = p;
+}
+
+bool endTrackSpline(TrackSplineStream& stream)
+{
+    TrackSpline& spline = *stream.spline;
+    const int NUM_CTRL = stream.received;
+    if (NUM_CTRL < MIN_TRACK_CTRL) {
+        spline.numCtrl = 0;
+        spline.spans.clear();
+        return false;
+    }
+
+    // sa 3 tacke svaki raspon koristi sve tri (neke dvaput) - obicna funkcija
+    if (NUM_CTRL == 3) {
+        buildTrackSpline(spline, stream.head, NUM_CTRL);
+        return true;
+    }
+
+    // zatvaranje petlje: rasponi n-2, n-1 i 0 koriste prve tacke
+    const Vec2* w = stream.window;     // tacke n-3, n-2, n-1
+    const Vec2* h = stream.head;       // tacke 0, 1, 2
+    spline.spans.push_back(catmullRomCoeffs(w[0], w[1], w[2], h[0], TRACK_SCALE_X));
+    spline.spans.push_back(catmullRomCoeffs(w[1], w[2], h[0], h[1], TRACK_SCALE_X));
+    spline.spans[0] = catmullRomCoeffs(w[2], h[0], h[1], h[2], TRACK_SCALE_X);
+    spline.numCtrl = NUM_CTRL;
+    return true;
+}
+
+// zakrivljenost krive u tacki t raspona: (x'y'' - y'x'') / |p'|^3
+static float spanCurvature(const SpanCoeffs& c, float t)
+{
+    Vec2 d1 = spanDerivative(c, t);
+    return spanCurvatureOf(d1, spanSecondDerivative(c, t), std::sqrt(d1.x * d1.x + d1.y * d1.y));
+}
+
+Vec2 splinePoint(const TrackSpline& spline, SplinePos pos)
+{
+    return spanPoint(spline.spans[pos.span], pos.t);
+}
+
+TrackFrame splineFrame(const TrackSpline& spline, SplinePos pos)
+{
+    const SpanCoeffs& c = spline.spans[pos.span];
+
+    TrackFrame f;
+    f.pos = spanPoint(c, pos.t);
+    f.tangent = normalize(spanDerivative(c, pos.t));
+    f.normal = { -f.tangent.y, f.tangent.x };
+    return f;
+}
+
+float splineCurvature(const TrackSpline& spline, SplinePos pos)
+{
+    return spanCurvature(spline.spans[pos.span], pos.t);
+}
+
+
+// ================== Pravljenje putanje (sine) ==================
+void buildTrack(TrackBuffer& track, const Vec2* ctrlPoints, int NUM_CTRL)    // prvi deo ravan, posle talasi
+{
+    TrackSpline spline;
+    if (buildTrackSpline(spline, ctrlPoints, NUM_CTRL))
+        buildTrack(track, spline);
+}
+
+// prva tacka ravnomerne staze koja pada u raspon seg (za seg == numCtrl: poslednja tacka)
+static int firstSampleOfSpan(int seg, int count, int NUM_CTRL)
+{
+    if (seg <= 0) return 0;
+    if (seg >= NUM_CTRL) return count - 1;
+
+    // tacka i ima parametar s = i / (count - 1) * NUM_CTRL, a raspon je floor(s)
+    const float denom = (float)(count - 1);
+    const float numCtrl = (float)NUM_CTRL;
+    auto spanOf = [&](int i) {
+        int sp = (int)std::floor((float)i / denom * numCtrl);
+        return sp < NUM_CTRL - 1 ? sp : NUM_CTRL - 1;
+    };
+
+    // procena, pa ispravka zbog zaokruzivanja
+    int i = (int)((long long)seg * (count - 1) / NUM_CTRL);
+    if (i > count - 1) i = count - 1;
+    while (i > 0 && spanOf(i - 1) >= seg) --i;
+    while (i < count - 1 && spanOf(i) < seg) ++i;
+    return i;
+}
+
+
+// racuna tacke raspona [spanBegin, spanEnd); svaki raspon je neprekidan niz tacaka
+// i koristi svoje vec izracunate koeficijente
+static void evalSpans(TrackBuffer& track, const TrackSpline& spline, int spanBegin, int spanEnd)
+{
+    static const SimdLevel simd = detectSimdLevel();   // SSE2/AVX2 ako procesor ima
+
+    const float denom = (float)(track.count - 1);
+    const float numCtrl = (float)spline.numCtrl;
+
+    int first = firstSampleOfSpan(spanBegin, track.count, spline.numCtrl);
+    for (int seg = spanBegin; seg < spanEnd; ++seg) {
+        int last = firstSampleOfSpan(seg + 1, track.count, spline.numCtrl);
+        evalSpan(simd, spline.spans[seg], first, last, denom, numCtrl, (float)seg,
+            track.x, track.y, track.tx, track.ty);
+        if (track.hasCurvature()) {
+            for (int i = first; i < last; ++i)
+                track.curvature[i] = spanCurvature(spline.spans[seg], (float)i / denom * numCtrl - (float)seg);
+        }
+        if (track.hasParam()) {
+            for (int i = first; i < last; ++i) {
+                track.span[i] = seg;
+                track.spanT[i] = (float)i / denom * numCtrl - (float)seg;
+            }
+        }
+        first = last;
+    }
+}
+
+// poslednja tacka je kopija prve (zatvorena staza), a kod otvorene krive kraj poslednjeg raspona.
+// Na krivoj je to u oba slucaja kraj poslednjeg raspona (da se izmedju pretposlednje i nje lepo interpolira).
+static void closeTrack(TrackBuffer& track, const TrackSpline& spline)
+{
+    const int last = track.count - 1;
+    if (track.hasParam()) {
+        track.span[last] = spline.numCtrl - 1;
+        track.spanT[last] = 1.0f;
+    }
+    if (!spline.closed) {
+        const SpanCoeffs& c = spline.spans[spline.numCtrl - 1];
+        Vec2 p = spanPoint(c, 1.0f);
+        track.x[last] = p.x;
+        track.y[last] = p.y;
+        if (track.hasTangents()) {
+            Vec2 d = normalize(spanDerivative(c, 1.0f));
+            track.tx[last] = d.x;
+            track.ty[last] = d.y;
+        }
+        if (track.hasCurvature())
+            track.curvature[last] = spanCurvature(c, 1.0f);
+        return;
+    }
+
+    track.x[last] = track.x[0];
+    track.y[last] = track.y[0];
+    if (track.hasTangents()) {
+        track.tx[last] = track.tx[0];
+        track.ty[last] = track.ty[0];
+    }
+    if (track.hasCurvature())
+        track.curvature[last] = track.curvature[0];
+}
+
+void buildTrack(TrackBuffer& track, const TrackSpline& spline, int numThreads)
+{
+    // svaka tacka zavisi samo od svog indeksa, pa niti dele raspone
+    parallelFor(spline.numCtrl, numThreads, [&](int spanBegin, int spanEnd) {
+        evalSpans(track, spline, spanBegin, spanEnd);
+    });
+    closeTrack(track, spline);
+    track.tolerance = 0.0f;
+
+    if (track.hasArcLength())
+        buildArcLength(track, numThreads);
+}
+
+
+// ================== Adaptivna putanja ==================
+static const int ADAPTIVE_MAX_DEPTH = 16;   // najvise 2^16 delova po rasponu
+
+// rastojanje tacke p od prave kroz a i b
+static float distanceToChord(Vec2 p, Vec2 a, Vec2 b)
+{
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len <= 0.0f)
+        return std::sqrt((p.x - a.x) * (p.x - a.x) + (p.y - a.y) * (p.y - a.y));
+    return std::fabs((p.x - a.x) * dy - (p.y - a.y) * dx) / len;
+}
+
+// deli [t0, t1] dok je tetiva dovoljno blizu krive; u "out" dodaje krajeve delova (bez t0)
+static void subdivideSpan(const SpanCoeffs& c, float t0, Vec2 p0, float t1, Vec2 p1,
+    float tolerance, int depth, std::vector<float>& out)
+{
+    // proveravamo cetvrtine, ne samo sredinu - inace se "S" oblik vidi kao ravan
+    float h = t1 - t0;
+    float tm = t0 + h * 0.5f;
+    Vec2 pm = spanPoint(c, tm);
+    float err = distanceToChord(pm, p0, p1);
+    err = std::fmax(err, distanceToChord(spanPoint(c, t0 + h * 0.25f), p0, p1));
+    err = std::fmax(err, distanceToChord(spanPoint(c, t0 + h * 0.75f), p0, p1));
+
+    // bar jedna podela po rasponu, da ni najravniji deo ne ostane samo jedna duz
+    if ((err <= tolerance && depth > 0) || depth >= ADAPTIVE_MAX_DEPTH) {
+        out.push_back(t1);
+        return;
     }
 
-    trackPoints[TRACK_SEGMENTS - 1] = trackPoints[0];   //zatvaranje staze
+    subdivideSpan(c, t0, p0, tm, pm, tolerance, depth + 1, out);
+    subdivideSpan(c, tm, pm, t1, p1, tolerance, depth + 1, out);
+}
+
+bool buildTrackAdaptive(TrackBuffer& track, const Vec2* ctrlPoints, int NUM_CTRL, float tolerance, int flags)
+{
+    TrackSpline spline;
+    return buildTrackSpline(spline, ctrlPoints, NUM_CTRL) && buildTrackAdaptive(track, spline, tolerance, flags);
+}
+
+bool buildTrackAdaptive(TrackBuffer& track, const TrackSpline& spline, float tolerance, int flags, int numThreads)
+{
+    const int NUM_CTRL = spline.numCtrl;
+
+    // prvo raspon i t svih tacaka, pa tek onda znamo koliko ih ima;
+    // svaki raspon se deli nezavisno, pa svaka nit puni svoju listu (spajaju se redom)
+    struct SpanSamples {
+        std::vector<int>   span;
+        std::vector<float> t;
+    };
+    if (numThreads <= 0) numThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    const int numChunks = std::max(1, std::min(numThreads, NUM_CTRL));
+    std::vector<SpanSamples> chunks(numChunks);
+
+    parallelFor(numChunks, numChunks, [&](int chunkBegin, int chunkEnd) {
+        std::vector<float> spanT;
+        for (int chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            SpanSamples& out = chunks[chunk];
+            int segBegin = (int)((long long)NUM_CTRL * chunk / numChunks);
+            int segEnd = (int)((long long)NUM_CTRL * (chunk + 1) / numChunks);
+            for (int seg = segBegin; seg < segEnd; ++seg) {
+                const SpanCoeffs& c = spline.spans[seg];
+
+                spanT.clear();
+                subdivideSpan(c, 0.0f, spanPoint(c, 0.0f), 1.0f, spanPoint(c, 1.0f), tolerance, 0, spanT);
+
+                // pocetak raspona, pa unutrasnje tacke (kraj = pocetak sledeceg raspona)
+                out.span.push_back(seg);
+                out.t.push_back(0.0f);
+                for (size_t k = 0; k + 1 < spanT.size(); ++k) {
+                    out.span.push_back(seg);
+                    out.t.push_back(spanT[k]);
+                }
+            }
+        }
+    });
+
+    std::vector<int>   sampleSpan;
+    std::vector<float> sampleT;
+    for (const SpanSamples& chunk : chunks) {
+        sampleSpan.insert(sampleSpan.end(), chunk.span.begin(), chunk.span.end());
+        sampleT.insert(sampleT.end(), chunk.t.begin(), chunk.t.end());
+    }
+
+    int count = (int)sampleSpan.size() + 1;   // + zatvaranje staze
+    if (!allocateTrack(track, count, flags)) return false;
+
+    parallelFor(count - 1, numThreads, [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            const SpanCoeffs& c = spline.spans[sampleSpan[i]];
+            float t = sampleT[i];
+
+            Vec2 p = spanPoint(c, t);
+            track.x[i] = p.x;
+            track.y[i] = p.y;
+
+            if (track.hasTangents()) {
+                Vec2 d = normalize(spanDerivative(c, t));
+                track.tx[i] = d.x;
+                track.ty[i] = d.y;
+            }
+            if (track.hasCurvature())
+                track.curvature[i] = spanCurvature(c, t);
+            if (track.hasParam()) {
+                track.span[i] = sampleSpan[i];
+                track.spanT[i] = t;
+            }
+        }
+    });
+
+    closeTrack(track, spline);
+    track.tolerance = tolerance;
+
+    if (track.hasArcLength())
+        buildArcLength(track, numThreads);
+
+    return true;
 }
 
 
 // vrati poziciju na sini za zadati parametar t u [0,1]
-Vec2 sampleTrack(float t, const Vec2* trackPoints, int TRACK_SEGMENTS)
+Vec2 sampleTrack(float t, const TrackBuffer& track)
 {
+    const int TRACK_SEGMENTS = track.count;
+
     // t u [0,1), ali dozvoljava i >1 / <0 (vrti u krug)
-    if (t <= 0.0f) return trackPoints[0];
-    if (t >= 1.0f) return trackPoints[TRACK_SEGMENTS - 1];
+    if (t <= 0.0f) return { track.x[0], track.y[0] };
+    if (t >= 1.0f) return { track.x[TRACK_SEGMENTS - 1], track.y[TRACK_SEGMENTS - 1] };
 
     float fIndex = t * (float)(TRACK_SEGMENTS - 1);
     int   i0 = (int)std::floor(fIndex);
     int   i1 = i0 + 1;
     float alpha = fIndex - (float)i0;
 
-    Vec2 p0 = trackPoints[i0];
-    Vec2 p1 = trackPoints[i1];
-
     Vec2 p;
-    p.x = p0.x + (p1.x - p0.x) * alpha;
-    p.y = p0.y + (p1.y - p0.y) * alpha;
+    p.x = track.x[i0] + (track.x[i1] - track.x[i0]) * alpha;
+    p.y = track.y[i0] + (track.y[i1] - track.y[i0]) * alpha;
     return p;
 }
 
 
-// ugao sine u tacki t  NUMERICKI iz sampleTrack, da uvek prati pravu putanju
-float trackAngle(float t, const Vec2* trackPoints, int TRACK_SEGMENTS)
+// ugao sine u tacki t - iz tabele tangenti ako postoji, inace numericki iz sampleTrack
+float trackAngle(float t, const TrackBuffer& track)
 {
-    const float eps = 1.0f / (float)TRACK_SEGMENTS;
+    if (track.hasTangents()) {
+        TrackFrame f = sampleTrackFrame(t, track);
+        return std::atan2(f.tangent.y, f.tangent.x);
+    }
+
+    const float eps = 1.0f / (float)track.count;
 
-    Vec2 p0 = sampleTrack(t - eps, trackPoints, TRACK_SEGMENTS);
-    Vec2 p1 = sampleTrack(t + eps, trackPoints, TRACK_SEGMENTS);
+    Vec2 p0 = sampleTrack(t - eps, track);
+    Vec2 p1 = sampleTrack(t + eps, track);
 
     float dx = p1.x - p0.x;
     float dy = p1.y - p0.y;
 
     return std::atan2(dy, dx);
+}
+
+
+// pozicija i tangenta iz istog para susednih tacaka - jedna interpolacija za sve
+TrackFrame sampleTrackFrame(float t, const TrackBuffer& track)
+{
+    const int TRACK_SEGMENTS = track.count;
+    TrackFrame f;
+
+    int   i0, i1;
+    float alpha;
+    if (t <= 0.0f || t >= 1.0f) {
+        i0 = i1 = (t <= 0.0f) ? 0 : TRACK_SEGMENTS - 1;
+        alpha = 0.0f;
+    }
+    else {
+        float fIndex = t * (float)(TRACK_SEGMENTS - 1);
+        i0 = (int)fIndex;
+        i1 = i0 + 1;
+        alpha = fIndex - (float)i0;
+    }
+
+    f.pos.x = track.x[i0] + (track.x[i1] - track.x[i0]) * alpha;
+    f.pos.y = track.y[i0] + (track.y[i1] - track.y[i0]) * alpha;
+
+    // susedne tangente su skoro iste, pa posle lerp-a samo vratimo duzinu na 1
+    Vec2 tg;
+    tg.x = track.tx[i0] + (track.tx[i1] - track.tx[i0]) * alpha;
+    tg.y = track.ty[i0] + (track.ty[i1] - track.ty[i0]) * alpha;
+    f.tangent = normalize(tg);
+
+    // normala je tangenta rotirana za +90 stepeni - ne treba joj poseban niz
+    f.normal = { -f.tangent.y, f.tangent.x };
+
+    return f;
+}
+
+
+// ================== Duzina luka ==================
+// Kumulativne duzine se sabiraju u blokovima: unutar bloka zbir od pocetka bloka, pa se doda
+// vrednost tacke pre bloka. Blokovi ne zavise od broja niti, pa je rezultat isti bit za bit
+// i kad se blokovi sabiraju paralelno (a i kad se racuna samo od izmenjenog bloka).
+static const int ARC_SCAN_BLOCK = 4096;
+
+// zbir duzina unutar bloka [first, last) (bez vrednosti pre bloka)
+static void scanArcBlock(TrackBuffer& track, int first, int last)
+{
+    float local = 0.0f;
+    for (int i = first; i < last; ++i) {
+        float dx = track.x[i] - track.x[i - 1];
+        float dy = track.y[i] - track.y[i - 1];
+        local += std::sqrt(dx * dx + dy * dy);
+        track.arcLen[i] = local;
+    }
+}
+
+// obrnuta tabela: za ravnomerno rasporedjene duzine pamtimo t,
+// pa je kasnije trazenje samo jedno deljenje i jedna interpolacija (bez binarne pretrage)
+static void buildArcTable(TrackBuffer& track, int kBegin, int kEnd)
+{
+    const int TRACK_SEGMENTS = track.count;
+    const float* cumulative = track.arcLen;
+    const int tableSize = track.arcTableSize;
+
+    // prvi segment ciji kraj nije pre s; dalje se samo pomera napred
+    int seg = 0;
+    if (kBegin > 0) {
+        float s = track.totalLength * (float)kBegin / (float)tableSize;
+        seg = (int)(std::lower_bound(cumulative + 1, cumulative + TRACK_SEGMENTS - 1, s) - (cumulative + 1));
+    }
+
+    for (int k = kBegin; k < kEnd; ++k) {
+        float s = track.totalLength * (float)k / (float)tableSize;
+
+        while (seg < TRACK_SEGMENTS - 2 && cumulative[seg + 1] < s)
+            ++seg;
+
+        float segLen = cumulative[seg + 1] - cumulative[seg];
+        float alpha = (segLen > 0.0f) ? (s - cumulative[seg]) / segLen : 0.0f;
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (alpha > 1.0f) alpha = 1.0f;
+
+        track.arcT[k] = ((float)seg + alpha) / (float)(TRACK_SEGMENTS - 1);
+    }
+}
+
+// kumulativne duzine od bloka sa tackom "from" do kraja (ranije vrednosti su vec dobre),
+// pa obrnuta tabela - ona zavisi od ukupne duzine, pa se uvek pravi cela
+static void updateArcLength(TrackBuffer& track, int from, int numThreads)
+{
+    const int TRACK_SEGMENTS = track.count;
+    float* cumulative = track.arcLen;
+
+    // blok b pokriva tacke [1 + b*BLOCK, 1 + (b+1)*BLOCK)
+    cumulative[0] = 0.0f;
+    if (from < 1) from = 1;
+    const int firstBlock = (from - 1) / ARC_SCAN_BLOCK;
+    const int numBlocks = (TRACK_SEGMENTS - 2) / ARC_SCAN_BLOCK + 1;
+    auto blockFirst = [](int b) { return 1 + b * ARC_SCAN_BLOCK; };
+    auto blockLast = [&](int b) { return std::min(TRACK_SEGMENTS, 1 + (b + 1) * ARC_SCAN_BLOCK); };
+
+    // 1) zbir unutar svakog bloka (paralelno)
+    parallelFor(numBlocks - firstBlock, numThreads, [&](int bBegin, int bEnd) {
+        for (int b = firstBlock + bBegin; b < firstBlock + bEnd; ++b)
+            scanArcBlock(track, blockFirst(b), blockLast(b));
+    });
+
+    // 2) vrednost pre svakog bloka - redom, jedno sabiranje po bloku
+    std::vector<float> blockBase(numBlocks - firstBlock);
+    float base = cumulative[blockFirst(firstBlock) - 1];
+    for (int b = firstBlock; b < numBlocks; ++b) {
+        blockBase[b - firstBlock] = base;
+        base = base + cumulative[blockLast(b) - 1];
+    }
+
+    // 3) dodavanje vrednosti pre bloka (paralelno)
+    parallelFor(numBlocks - firstBlock, numThreads, [&](int bBegin, int bEnd) {
+        for (int b = firstBlock + bBegin; b < firstBlock + bEnd; ++b) {
+            const float blockStart = blockBase[b - firstBlock];
+            for (int i = blockFirst(b); i < blockLast(b); ++i)
+                cumulative[i] = blockStart + cumulative[i];
+        }
+    });
+    track.totalLength = cumulative[TRACK_SEGMENTS - 1];
+
+    parallelFor(track.arcTableSize + 1, numThreads, [&](int kBegin, int kEnd) {
+        buildArcTable(track, kBegin, kEnd);
+    });
+}
+
+bool copyTrack(TrackBuffer& dst, const TrackBuffer& src)
+{
+    int flags = (src.hasTangents() ? TRACK_TANGENTS : 0) |
+                (src.hasArcLength() ? TRACK_ARC_LENGTH : 0) |
+                (src.hasParam() ? TRACK_PARAM : 0) |
+                (src.hasCurvature() ? TRACK_CURVATURE : 0);
+    if (!allocateTrack(dst, src.count, flags)) return false;
+
+    const size_t bytes = (size_t)src.count * sizeof(float);
+    std::memcpy(dst.x, src.x, bytes);
+    std::memcpy(dst.y, src.y, bytes);
+    if (src.hasTangents()) {
+        std::memcpy(dst.tx, src.tx, bytes);
+        std::memcpy(dst.ty, src.ty, bytes);
+    }
+    if (src.hasArcLength()) {
+        // tabela kopije ima istu velicinu samo ako je i izvor pravljen sa ARC_TABLE_RESOLUTION
+        std::memcpy(dst.arcLen, src.arcLen, bytes);
+        if (src.arcTableSize == dst.arcTableSize)
+            std::memcpy(dst.arcT, src.arcT, (size_t)(src.arcTableSize + 1) * sizeof(float));
+        else
+            buildArcLength(dst);
+    }
+    if (src.hasParam()) {
+        std::memcpy(dst.span, src.span, bytes);
+        std::memcpy(dst.spanT, src.spanT, bytes);
+    }
+    if (src.hasCurvature()) std::memcpy(dst.curvature, src.curvature, bytes);
+
+    dst.totalLength = src.totalLength;
+    dst.tolerance = src.tolerance;
+    return true;
+}
+
+void buildArcLength(TrackBuffer& track, int numThreads)
+{
+    updateArcLength(track, 1, numThreads);
+}
+
+
+// ================== Pomeranje kontrolne tacke ==================
+static int trackFlags(const TrackBuffer& track)
+{
+    return (track.hasTangents() ? TRACK_TANGENTS : 0) |
+           (track.hasArcLength() ? TRACK_ARC_LENGTH : 0) |
+           (track.hasParam() ? TRACK_PARAM : 0) |
+           (track.hasCurvature() ? TRACK_CURVATURE : 0);
+}
+
+// prva tacka adaptivne staze u rasponu seg (span[] raste duz staze)
+static int firstSampleOfAdaptiveSpan(const TrackBuffer& track, int seg)
+{
+    return (int)(std::lower_bound(track.span, track.span + track.count - 1, seg) - track.span);
+}
+
+// tacke [first, last) adaptivne staze na njihovim (raspon, t)
+static void evalSamples(TrackBuffer& track, const TrackSpline& spline, int first, int last)
+{
+    for (int i = first; i < last; ++i) {
+        const SpanCoeffs& c = spline.spans[track.span[i]];
+        float t = track.spanT[i];
+
+        Vec2 p = spanPoint(c, t);
+        track.x[i] = p.x;
+        track.y[i] = p.y;
+        if (track.hasTangents()) {
+            Vec2 d = normalize(spanDerivative(c, t));
+            track.tx[i] = d.x;
+            track.ty[i] = d.y;
+        }
+        if (track.hasCurvature())
+            track.curvature[i] = spanCurvature(c, t);
+    }
+}
+
+bool retessellateTrack(TrackBuffer& track, const TrackSpline& spline, int numThreads)
+{
+    if (track.tolerance <= 0.0f) return false;
+
+    TrackBuffer rebuilt;
+    if (!buildTrackAdaptive(rebuilt, spline, track.tolerance, trackFlags(track), numThreads))
+        return false;
+    track = std::move(rebuilt);
+    return true;
+}
+
+TrackUpdate updateControlPoint(TrackBuffer& track, TrackSpline& spline, Vec2* ctrlPoints, int index, Vec2 newPos)
+{
+    const int NUM_CTRL = spline.numCtrl;
+    TrackUpdate update;
+
+    ctrlPoints[index] = newPos;
+
+    // tacka i je p0..p3 za raspone i+1, i, i-1, i-2 - samo njima se menjaju koeficijenti
+    for (int k = -2; k <= 1; ++k) {
+        int seg = ((index + k) % NUM_CTRL + NUM_CTRL) % NUM_CTRL;
+        int i0 = (seg - 1 + NUM_CTRL) % NUM_CTRL;
+        int i1 = (seg + 0) % NUM_CTRL;
+        int i2 = (seg + 1) % NUM_CTRL;
+        int i3 = (seg + 2) % NUM_CTRL;
+        spline.spans[seg] = catmullRomCoeffs(
+            ctrlPoints[i0], ctrlPoints[i1],
+            ctrlPoints[i2], ctrlPoints[i3], TRACK_SCALE_X);
+    }
+
+    // adaptivna staza bez (raspon, t) tacaka - ne zna se koje tacke pripadaju rasponima, pa pravimo novu
+    const bool adaptive = track.tolerance > 0.0f;
+    if (adaptive && !track.hasParam()) {
+        retessellateTrack(track, spline);
+        update.ranges[0] = { 0, track.count };
+        update.numRanges = 1;
+        update.resized = true;
+        return update;
+    }
+
+    // malo kontrolnih tacaka - sva 4 raspona su cela staza
+    if (NUM_CTRL <= 4 && !adaptive) {
+        buildTrack(track, spline);
+        update.ranges[0] = { 0, track.count };
+        update.numRanges = 1;
+        return update;
+    }
+
+    // raspone [index-2, index+1] delimo na najvise dva neprekidna dela (ako predju preko pocetka)
+    int spanLo = index - 2;
+    int spanHi = index + 2;     // bez njega
+    int spanRuns[2][2];
+    int numRuns = 0;
+    if (NUM_CTRL <= 4) {
+        spanRuns[numRuns][0] = 0; spanRuns[numRuns][1] = NUM_CTRL; ++numRuns;
+    }
+    else if (spanLo < 0) {
+        spanRuns[numRuns][0] = spanLo + NUM_CTRL; spanRuns[numRuns][1] = NUM_CTRL; ++numRuns;
+        spanRuns[numRuns][0] = 0;                 spanRuns[numRuns][1] = spanHi;   ++numRuns;
+    }
+    else if (spanHi > NUM_CTRL) {
+        spanRuns[numRuns][0] = spanLo; spanRuns[numRuns][1] = NUM_CTRL;          ++numRuns;
+        spanRuns[numRuns][0] = 0;      spanRuns[numRuns][1] = spanHi - NUM_CTRL; ++numRuns;
+    }
+    else {
+        spanRuns[numRuns][0] = spanLo; spanRuns[numRuns][1] = spanHi; ++numRuns;
+    }
+
+    int firstDirty = track.count;
+    bool firstSampleDirty = false;
+    for (int r = 0; r < numRuns; ++r) {
+        TrackRange range;
+        if (adaptive) {
+            // podela ostaje ista dok se vuce - samo se tacke racunaju ponovo
+            range.first = firstSampleOfAdaptiveSpan(track, spanRuns[r][0]);
+            range.last = (spanRuns[r][1] >= NUM_CTRL) ? track.count - 1 : firstSampleOfAdaptiveSpan(track, spanRuns[r][1]);
+            evalSamples(track, spline, range.first, range.last);
+        }
+        else {
+            evalSpans(track, spline, spanRuns[r][0], spanRuns[r][1]);
+            range.first = firstSampleOfSpan(spanRuns[r][0], track.count, NUM_CTRL);
+            range.last = firstSampleOfSpan(spanRuns[r][1], track.count, NUM_CTRL);
+        }
+        if (range.last == track.count - 1) range.last = track.count;   // i tacka zatvaranja
+        update.ranges[update.numRanges++] = range;
+
+        if (range.first < firstDirty) firstDirty = range.first;
+        if (range.first == 0) firstSampleDirty = true;
+    }
+
+    // promenjena prva tacka -> i poslednja (ista je)
+    if (firstSampleDirty) {
+        closeTrack(track, spline);
+        bool covered = false;
+        for (int r = 0; r < update.numRanges; ++r)
+            if (update.ranges[r].last == track.count) covered = true;
+        if (!covered)
+            update.ranges[update.numRanges++] = { track.count - 1, track.count };
+    }
+
+    if (track.hasArcLength())
+        updateArcLength(track, firstDirty, 1);
+
+    return update;
+}
+
+
+// predjeni put -> t; staza je zatvorena pa se s vrti u krug
+float arcLengthToT(float s, const TrackBuffer& track)
+{
+    if (track.totalLength <= 0.0f) return 0.0f;
+
+    s = std::fmod(s, track.totalLength);
+    if (s < 0.0f) s += track.totalLength;
+
+    int tableSize = track.arcTableSize;
+    float fIndex = s / track.totalLength * (float)tableSize;
+    int   k = (int)fIndex;
+    if (k >= tableSize) k = tableSize - 1;
+    float alpha = fIndex - (float)k;
+
+    return track.arcT[k] + (track.arcT[k + 1] - track.arcT[k]) * alpha;
+}
+
+
+Vec2 sampleTrackAtDistance(float s, const TrackBuffer& track)
+{
+    return sampleTrack(arcLengthToT(s, track), track);
+}
+
+// t u [0,1] -> raspon i lokalno t u njemu
+SplinePos trackTToSplinePos(float t, const TrackBuffer& track, int numCtrl)
+{
+    SplinePos pos;
+    if (t <= 0.0f) return pos;
+    if (t >= 1.0f) {
+        pos.span = numCtrl - 1;
+        pos.t = 1.0f;
+        return pos;
+    }
+
+    // ravnomerna staza: tacka i je bas na i / (count - 1) cele krive
+    if (!track.hasParam()) {
+        double s = (double)t * numCtrl;
+        pos.span = std::min((int)s, numCtrl - 1);
+        pos.t = (float)(s - pos.span);
+        return pos;
+    }
+
+    float fIndex = t * (float)(track.count - 1);
+    int   i0 = (int)fIndex;
+    int   i1 = i0 + 1;
+    float alpha = fIndex - (float)i0;
+
+    // t druge tacke racunato od raspona prve (sledeci raspon pocinje na 1)
+    float t1 = track.spanT[i1] + (float)(track.span[i1] - track.span[i0]);
+    float local = track.spanT[i0] + (t1 - track.spanT[i0]) * alpha;
+    int   whole = (int)local;
+    pos.span = std::min(track.span[i0] + whole, numCtrl - 1);
+    pos.t = local - (float)(pos.span - track.span[i0]);
+    return pos;
 }
\ No newline at end of file
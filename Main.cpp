@@ -2,10 +2,23 @@
 #include <GLFW/glfw3.h>
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include "Util.h"
 #include "Helpers.h"
+#include "BakedTrack.h"
+#include "TrackIndex.h"
+#include "TrackFile.h"
+#include "TrackLayout.h"
+#include "TrackPhase.h"
+#include "TrackSimd.h"
+#include "TrackProfile.h"
+#include "TrackLod.h"
+#include "TrackCheck.h"
+#include "TrackQuant.h"
+#include "TrackGenerator.h"
+#include "Ride.h"
 
 #include <thread>
 #include <chrono>
@@ -14,60 +27,58 @@
 // ================== Konstante ==================
 int SCREEN_WIDTH = 800;
 int SCREEN_HEIGHT = 800;
-const int TRACK_SEGMENTS = 400;
-const int MAX_SEATS = 8;
+const int TRACK_SEGMENTS = 400;     // broj tacaka staze kad se deli ravnomerno (Uniform i Baked)
+const float TRACK_TOLERANCE = 0.0003f;  // najvece odstupanje tetive od krive (NDC) za adaptivnu podelu
+const char* TRACK_FILE = "res/track.bin";   // gotova staza; pravi se ponovo kad se promeni raspored ili nacin pravljenja
+const char* TRACK_LAYOUT_FILE = "res/track.txt";   // kontrolne tacke (ili .csv); ako ga nema - TRACK_LAYOUT
+const int GENERATED_LAYOUT_POINTS = 0;     // > 0: umesto TRACK_LAYOUT generisan raspored sa toliko tacaka (test opterecenja)
+const uint64_t GENERATED_LAYOUT_SEED = 1;
+const int PARALLEL_BUILD_MIN_CTRL = 1024;   // od ovoliko kontrolnih tacaka staza se pravi na svim jezgrima
+const bool TRACK_QUANTIZED = false;   // sine iz 16-bitne sabijene staze - upola manji VBO (za slabije uredjaje)
 const float RAIL_HALF_SPACING = 0.025f;   // rastojanje izmedju sina
-
-// brzine
-const float START_ACCEL = 0.75f;   // ubrzanje pri startu
-const float TARGET_SPEED = 0.22f;   // bazna brzina na ravnom
-const float GRAVITY_ACCEL = 1.0f;   // koliko nagib utice
-const float MIN_SPEED = 0.04f;
-const float MAX_SPEED = 0.60f;
-const float BRAKE_ACCEL = 0.40f;   // kocenje kad je nekome lose
-const float RETURN_SPEED = 0.06f;   // mala brzina ka pocetku
-const double PAUSE_DURATION = 10.0;   // pauza kad je nekome lose (s)
+const float WAGON_WIDTH = 0.28f;
+const float WAGON_HEIGHT = 0.12f;
+const double MAX_FRAME_TIME = 0.25;      // duzi frejm (npr. pomeranje prozora) se simulira kao ovoliki
 
 // ================== Pomocne strukture ==================
-struct Passenger {
-    bool present;  // da li sedi
-    bool beltOn;   // za kasnije
-    bool sick;     // za kasnije (tasteri 1-8)
-};
-
-enum class RideState {   // stanje voznje
-    BOARDING,        // dodavanje putnika / vezivanje pojaseva
-    ACCELERATING,    // ubrzava posle ENTER-a
-    RUNNING,         // normalna voznja
-    STOPPING_SICK,   // koci jer je nekome lose
-    PAUSED_SICK,     // stoji 10 s
-    RETURNING        // vraca se ka pocetku malom brzinom
+enum class TrackMode {    // kako se pravi staza
+    Baked,           // izracunata pri kompajliranju (fiksne kontrolne tacke, nula posla pri pokretanju)
+    Uniform,         // TRACK_SEGMENTS jednakih delova pri pokretanju
+    Adaptive         // deli se po krivini do TRACK_TOLERANCE
 };
+const TrackMode TRACK_MODE = TrackMode::Adaptive;
 
 // ================== Globalni podaci ==================
-Vec2 trackPoints[TRACK_SEGMENTS];
-Passenger passengers[MAX_SEATS];
+TrackFile   trackFile;           // mapiran res/track.bin (ako se staza ucitava iz njega)
+TrackBuffer track;              // tacke, tangente i duzine luka staze (SoA)
+TrackSpline trackSpline;        // koeficijenti krive - tacna pozicija vagona izmedju tacaka
+TrackIndex  trackIndex;                // za trazenje najblize tacke staze (misem)
+bool        trackIndexDirty = true;    // staza izmenjena posle poslednjeg buildTrackIndex
+TrackProfile trackProfile;      // visina / nagib / zakrivljenost po predjenom putu - za fiziku
+bool        trackProfileDirty = false;  // staza pomerana - profil se pravi tek kad krene voznja
+TrackLod    trackLod;           // pojednostavljene verzije sina (indeksi u VBO staze)
+bool        trackLodDirty = true;   // staza izmenjena - crta se puna dok se nivoi ne naprave ponovo
+bool        trackTessDirty = false; // adaptivna staza pomerana - nova podela kad se pusti tacka
+
+// GPU objekti za sabijene sine
+struct QuantRailsGpu {
+    GLuint shader = 0;
+    GLuint vao = 0, vbo = 0;
+    GLuint chunkBuffer = 0, chunkTex = 0;   // buffer tekstura sa ishodistima i korakom delova
+};
+Ride ride;                      // vagon, putnici i stanje voznje (Ride.cpp)
+RideParams rideParams;          // brzine i ubrzanja voznje
 Vec2 seatWorldPos[MAX_SEATS];   // gde su sedista (za klik)
 
-int passengerCount = 0;
 bool spaceWasPressed = false;
 bool enterWasPressed = false;
 bool leftMouseWasPressed = false;
+int  draggedCtrlPoint = -1;                     // desni klik - koja kontrolna tacka se vuce
+double lastDragX = 0.0, lastDragY = 0.0;
 bool bKeyWasPressed = false;                   // za B (svi pojasevi)
 bool rKeyWasPressed = false;                   // za R (reset)
 bool numKeyWasPressed[MAX_SEATS] = { false };  // za 1–8
 
-// parametar kretanja po sini [0,1]
-float wagonT = 0.0f;            //pocetak putanje
-float wagonSpeed = 0.15f;          //  “brzina” po putanji (t u sekundi)
-bool rideRunning = false;          //  da li se vagon trenutno vozi
-
-RideState rideState = RideState::BOARDING;
-bool      clearingPassengers = false;  // posle povratka klik skida putnike
-double    sickPauseTimer = 0.0;
-int       sickPassengerIndex = -1;
-bool      returningForward = false;
-
 Vec2 seatOffsets[MAX_SEATS] = {
     {  0.10f, -0.04f },
     {  0.08f,  0.03f },
@@ -79,94 +90,62 @@ Vec2 seatOffsets[MAX_SEATS] = {
     { -0.10f,  0.03f },   // gornje levo (x,y)   po 2 u redu
 };
 
-// Kontrolne tacke pruge (grubo kao na tvojoj slici)
-const int NUM_CTRL = 10;   // broj kontrolnih tacaka
-Vec2 ctrlPoints[NUM_CTRL] = {
-    // leva strana – start i bregovi
-    { -0.90f, -0.30f },   // 0 start
-    { -0.65f,  0.10f },   // 1 prvi uspon
-    { -0.35f,  0.55f },   // 2 veliki vrh
-    { -0.05f,  0.05f },   // 3 dolina
-    //drugi veci breg
-    {  0.35f,  0.80f },   // 4 veliki vrh
-    {  0.60f,  0.05f },   // 5 dolina iza njega
-    // treci, uzi breg
-    {  0.85f,  0.45f },   // 6 treci vrh
-    {  0.95f,  0.00f },   // 7 spustanje
-    // dugacka donja ravnina nazad ka pocetku
-    {  0.50f, -0.35f },   // 8 donja desno
-    { -0.40f, -0.35f }    // 9 donja blizu starta (zatvaranje)
-};
-
-// ================== Reset putnika i svega ==================
-void resetPassengers()
+// cela staza za TrackMode::Baked, ugradjena u program; template da bi se
+// racunala (pri kompajliranju) samo kad je MODE Baked
+// (za mnogo vecu TRACK_SEGMENTS MSVC-u treba veci /constexpr:steps)
+template <TrackMode MODE>
+void attachLayoutTrack(TrackBuffer& track)
 {
-    passengerCount = 0;
-    for (int i = 0; i < MAX_SEATS; ++i) {
-        passengers[i].present = false;
-        passengers[i].beltOn = false;
-        passengers[i].sick = false;
+    if constexpr (MODE == TrackMode::Baked) {
+        static constexpr BakedTrack<TRACK_SEGMENTS> bakedTrack = bakeTrack<TRACK_SEGMENTS>(TRACK_LAYOUT);
+        attachBakedTrack(track, bakedTrack);    // samo pokazivaci na ugradjene nizove
     }
 }
-void fullReset()
+
+// od cega bi staza sada bila napravljena - TRACK_FILE vazi samo ako je napravljen od istog
+TrackBuildKey currentTrackBuildKey()
 {
-    // polozaj i brzina
-    wagonT = 0.0f;
-    wagonSpeed = 0.0f;
-    rideRunning = false;  
+    TrackBuildKey key{};
+    key.mode = (uint32_t)TRACK_MODE;
+    key.tolerance = (TRACK_MODE == TrackMode::Adaptive) ? TRACK_TOLERANCE : 0.0f;
+    key.segments = (TRACK_MODE == TrackMode::Adaptive) ? 0 : TRACK_SEGMENTS;
+
+    // isti redosled kao pri pravljenju: fajl rasporeda, pa generisan, pa TRACK_LAYOUT
+    if (hashTrackSourceFile(TRACK_LAYOUT_FILE, key.sourceHash)) {
+        key.source = TrackSource::LayoutFile;
+    }
+    else if (GENERATED_LAYOUT_POINTS > 0) {
+        const uint64_t generator[2] = { (uint64_t)GENERATED_LAYOUT_POINTS, GENERATED_LAYOUT_SEED };
+        key.source = TrackSource::Generated;
+        key.sourceHash = hashTrackSource(generator, sizeof(generator));
+    }
+    else {
+        key.source = TrackSource::Builtin;
+        key.sourceHash = hashTrackSource(TRACK_LAYOUT.data(), TRACK_LAYOUT.size() * sizeof(Vec2));
+    }
+    return key;
+}
 
-    // stanje voznje
-    rideState = RideState::BOARDING;
-    clearingPassengers = false;
-    sickPauseTimer = 0.0;
-    sickPassengerIndex = -1;
+// trenutne kontrolne tacke (TRACK_LAYOUT ili iz fajla) - mogu da se pomeraju misem (desni klik) dok se ukrcava
+std::vector<Vec2> ctrlPoints(TRACK_LAYOUT.begin(), TRACK_LAYOUT.end());
 
-    // putnici
-    resetPassengers();
+// ================== Reset svega ==================
+void fullReset()
+{
+    resetRide(ride);
 
     // “edge trigger” promenljive za tastaturu/mis
     spaceWasPressed = false;
     enterWasPressed = false;
     leftMouseWasPressed = false;
+    draggedCtrlPoint = -1;
     bKeyWasPressed = false;
     rKeyWasPressed = false;
     for (int i = 0; i < MAX_SEATS; ++i)
         numKeyWasPressed[i] = false;
     std::cout << "RESET: sve vraceno na pocetak.\n";
 }
-void finishReturnToStart()
-{
-    wagonT = 0.0f;
-    wagonSpeed = 0.0f;
-
-    // automatski odvezi sve putnike i izleci ih
-    for (int i = 0; i < MAX_SEATS; ++i) {
-        if (passengers[i].present) {
-            passengers[i].beltOn = false;
-            passengers[i].sick = false;
-        }
-    }
 
-    sickPassengerIndex = -1;
-    clearingPassengers = true;       // klik izbacuje putnike
-    rideState = RideState::BOARDING; // opet stanje ukrcavanja
-}
-
-// ================== Dodavanje putnika (Space) ==================
-void addPassenger()
-{
-    if (passengerCount >= MAX_SEATS) return; // pun vagon
-
-    for (int i = 0; i < MAX_SEATS; ++i) {
-        if (!passengers[i].present) {
-            passengers[i].present = true;
-            passengers[i].beltOn = false;
-            passengers[i].sick = false;
-            passengerCount++;
-            break;
-        }
-    }
-}
 // ================== Toggle pojasa na klik misem ==================
 void toggleSeatBeltClick(float mouseX_ndc, float mouseY_ndc)
 {
@@ -175,35 +154,161 @@ void toggleSeatBeltClick(float mouseX_ndc, float mouseY_ndc)
 
     for (int i = 0; i < MAX_SEATS; ++i)
     {
-        if (!passengers[i].present) continue;   // prazno sediste nas ne zanima
+        if (!ride.passengers[i].present) continue;   // prazno sediste nas ne zanima
 
         Vec2 p = seatWorldPos[i];
 
         if (std::fabs(mouseX_ndc - p.x) <= halfW &&
             std::fabs(mouseY_ndc - p.y) <= halfH)
         {
-            if (clearingPassengers) {
-                // posle povratka – klik izbacuje putnika
-                passengers[i].present = false;
-                passengers[i].beltOn = false;
-                passengers[i].sick = false;
-                passengerCount--;
-                if (passengerCount <= 0) {
-                    clearingPassengers = false; // sad moze nova tura
-                }
-            }
-            else if (rideState == RideState::BOARDING) {
-                // normalno stanje – klik kaci/otkaci pojas
-                passengers[i].beltOn = !passengers[i].beltOn;
-            }
+            clickSeat(ride, i);
             break;
         }
     }
 }
 
-
 // ================== Iscrtavanje ==================
-void drawTrack(GLuint shader, GLuint vaoTrack, GLuint vaoQuad)      //SINE
+// ================== Slanje staze na GPU ==================
+// SoA: prvo svi x, pa svi y - bafer se puni direktno iz nizova staze
+void uploadTrack(GLuint vaoTrack, GLuint vboTrack)
+{
+    glBindVertexArray(vaoTrack);
+    glBindBuffer(GL_ARRAY_BUFFER, vboTrack);
+
+    GLsizeiptr trackBytes = (GLsizeiptr)track.count * sizeof(float);
+    glBufferData(GL_ARRAY_BUFFER, 2 * trackBytes, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, trackBytes, track.x);
+    glBufferSubData(GL_ARRAY_BUFFER, trackBytes, trackBytes, track.y);
+
+    // y blok pocinje posle count x-ova, pa se pokazivac menja kad se promeni broj tacaka
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);            // x
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)trackBytes);   // y
+    glEnableVertexAttribArray(1);
+}
+
+// nivoi detalja -> element buffer vezan za VAO staze
+void uploadTrackLod(GLuint vaoTrack, GLuint eboTrack)
+{
+    buildTrackLod(trackLod, track);
+
+    glBindVertexArray(vaoTrack);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboTrack);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, trackLod.indices.size() * sizeof(uint32_t),
+        trackLod.indices.data(), GL_DYNAMIC_DRAW);
+    trackLodDirty = false;
+}
+
+// proverava raspored: vagon ne sme da udari u drugi deo staze (sine + visina vagona).
+// Delovi blizi od dve duzine vagona duz staze su ista krivina (oba kraka tesnog okreta) - ne porede se.
+void reportTrackIssues()
+{
+    std::vector<TrackIssue> issues;
+    checkTrack(track, 2.0f * RAIL_HALF_SPACING + WAGON_HEIGHT, 2.0f * WAGON_WIDTH, issues);
+
+    for (const TrackIssue& issue : issues) {
+        if (issue.kind == TrackIssueKind::Intersection)
+            std::cout << "Staza se sece sama sa sobom kod (";
+        else
+            std::cout << "Delovi staze su preblizu (" << issue.distance << ") kod (";
+        std::cout << issue.point.x << ", " << issue.point.y << ")\n";
+    }
+}
+
+// sabija stazu i salje je na GPU: prvo svi dx, pa svi dy (int16), delovi u buffer teksturu.
+// Isti indeksi tacaka kao pun VBO, pa se koristi i isti element buffer (nivoi detalja).
+// Sa TRACK_QUANTIZED float VBO se ne pravi, a sabijena kopija postoji samo dok se salje.
+// Vraca koliko bajtova je na GPU-u.
+size_t uploadQuantTrack(QuantRailsGpu& gpu, GLuint eboTrack)
+{
+    QuantTrack trackQuant;
+    if (!quantizeTrackChunks(trackQuant, track, 0, (track.count + QUANT_CHUNK_POINTS - 1) / QUANT_CHUNK_POINTS))
+        return 0;
+
+    glBindVertexArray(gpu.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+    GLsizeiptr bytes = (GLsizeiptr)trackQuant.count * sizeof(int16_t);
+    glBufferData(GL_ARRAY_BUFFER, 2 * bytes, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, trackQuant.dx.data());
+    glBufferSubData(GL_ARRAY_BUFFER, bytes, bytes, trackQuant.dy.data());
+    glVertexAttribPointer(0, 1, GL_SHORT, GL_FALSE, sizeof(int16_t), (void*)0);       // dx
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 1, GL_SHORT, GL_FALSE, sizeof(int16_t), (void*)bytes);   // dy
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboTrack);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, gpu.chunkBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, trackQuant.chunks.size() * sizeof(QuantChunk),
+        trackQuant.chunks.data(), GL_DYNAMIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, gpu.chunkTex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, gpu.chunkBuffer);
+    return 2 * (size_t)bytes + trackQuant.chunks.size() * sizeof(QuantChunk);
+}
+
+// samo delovi koji sadrze tacke [first, last) - sabijaju se ponovo i idu na svoje mesto u baferima
+void uploadQuantTrackRange(QuantRailsGpu& gpu, TrackRange range)
+{
+    if (range.last <= range.first) return;
+
+    QuantTrack part;
+    const int firstChunk = range.first / QUANT_CHUNK_POINTS;
+    if (!quantizeTrackChunks(part, track, firstChunk, (range.last - 1) / QUANT_CHUNK_POINTS + 1)) return;
+
+    const GLintptr base = (GLintptr)firstChunk * QUANT_CHUNK_POINTS;
+    const GLsizeiptr bytes = (GLsizeiptr)part.count * sizeof(int16_t);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, base * sizeof(int16_t), bytes, part.dx.data());
+    glBufferSubData(GL_ARRAY_BUFFER, (track.count + base) * sizeof(int16_t), bytes, part.dy.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, gpu.chunkBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, (GLintptr)firstChunk * sizeof(QuantChunk),
+        part.chunks.size() * sizeof(QuantChunk), part.chunks.data());
+}
+
+// samo tacke [first, last) - po jedan glBufferSubData za x i za y blok
+void uploadTrackRange(GLuint vboTrack, TrackRange range)
+{
+    if (range.last <= range.first) return;
+
+    GLsizeiptr bytes = (GLsizeiptr)(range.last - range.first) * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, vboTrack);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.first * sizeof(float), bytes, track.x + range.first);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(track.count + range.first) * sizeof(float), bytes, track.y + range.first);
+}
+
+// najbliza kontrolna tacka misu (NDC), -1 ako nijedna nije dovoljno blizu
+// klik na samu prugu bira kontrolnu tacku najblizu tom mestu na krivoj
+int pickControlPoint(float xNdc, float yNdc)
+{
+    const float PICK_RADIUS = 0.06f;
+    const float RAIL_PICK_RADIUS = 0.03f;
+
+    int best = -1;
+    float bestDist2 = PICK_RADIUS * PICK_RADIUS;
+    for (int i = 0; i < (int)ctrlPoints.size(); ++i) {
+        float dx = ctrlPoints[i].x * TRACK_SCALE_X - xNdc;   // na ekranu je staza suzena po x
+        float dy = ctrlPoints[i].y - yNdc;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < bestDist2) {
+            bestDist2 = d2;
+            best = i;
+        }
+    }
+    if (best >= 0) return best;
+
+    if (trackIndexDirty) {
+        buildTrackIndex(trackIndex, track);
+        trackIndexDirty = false;
+    }
+    TrackProjection hit = projectToTrack(trackIndex, track, { xNdc, yNdc });
+    if (hit.distance < 0.0f || hit.distance > RAIL_PICK_RADIUS) return -1;
+
+    // kontrolna tacka i je pocetak raspona i
+    const int numCtrl = trackSpline.numCtrl;
+    SplinePos pos = trackTToSplinePos(hit.t, track, numCtrl);
+    return (pos.span + (pos.t >= 0.5f ? 1 : 0)) % numCtrl;
+}
+
+void drawTrack(GLuint shader, GLuint trackShader, GLuint vaoTrack, GLuint vaoQuad, const QuantRailsGpu& quantRails)      //SINE
 {
     glUseProgram(shader);
 
@@ -219,17 +324,46 @@ void drawTrack(GLuint shader, GLuint vaoTrack, GLuint vaoQuad)      //SINE
     glUniform1i(locMode, 1);  // blago osvetljenje
 
     // ===================== SINE ======================
-    glBindVertexArray(vaoTrack);
+    // sine imaju svoj sejder - x i y staze su dva posebna atributa (track.vert),
+    // a sabijene (TRACK_QUANTIZED) su jedine na GPU-u (track_q.vert)
+    const bool quantized = TRACK_QUANTIZED;
+    const GLuint railShader = quantized ? quantRails.shader : trackShader;
+    glUseProgram(railShader);
+    glUniform1i(glGetUniformLocation(railShader, "uMode"), 1);
+    if (quantized) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_BUFFER, quantRails.chunkTex);
+        glUniform1i(glGetUniformLocation(railShader, "uChunks"), 0);
+        glUniform1i(glGetUniformLocation(railShader, "uChunkPoints"), QUANT_CHUNK_POINTS);
+    }
+    glBindVertexArray(quantized ? quantRails.vao : vaoTrack);
     glLineWidth(4.0f);
 
+    // nivo detalja po velicini piksela: staza je u NDC, bez zuma i bez ispravke odnosa stranica
+    // (sejderi ne koriste uAspect), pa je piksel 2/sirina po x a 2/visina po y - uzima se manji
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const float unitsPerPixel = 2.0f / (float)std::max(1, std::max(viewport[2], viewport[3]));
+    int first = 0, count = track.count;
+    if (!trackLodDirty && !trackLod.levels.empty()) {
+        const TrackLodLevel& level = trackLod.levels[selectTrackLod(trackLod, unitsPerPixel)];
+        first = level.first;
+        count = level.count;
+    }
+    auto drawRail = [&]() {
+        if (trackLodDirty) glDrawArrays(GL_LINE_LOOP, 0, count);
+        else glDrawElements(GL_LINE_LOOP, count, GL_UNSIGNED_INT, (void*)(first * sizeof(uint32_t)));
+    };
+
     // leva sina (malo ulevo)
-    glUniform3f(locColor, 0.85f, 0.85f, 0.90f);
-    glUniform2f(locPos, -RAIL_HALF_SPACING, 0.0f);
-    glDrawArrays(GL_LINE_LOOP, 0, TRACK_SEGMENTS);
+    glUniform3f(glGetUniformLocation(railShader, "uColor"), 0.85f, 0.85f, 0.90f);
+    glUniform2f(glGetUniformLocation(railShader, "uPos"), -RAIL_HALF_SPACING, 0.0f);
+    drawRail();
 
     // desna sina (malo udesno)
-    glUniform2f(locPos, +RAIL_HALF_SPACING, 0.0f);
-    glDrawArrays(GL_LINE_LOOP, 0, TRACK_SEGMENTS);        
+    glUniform2f(glGetUniformLocation(railShader, "uPos"), +RAIL_HALF_SPACING, 0.0f);
+    drawRail();
+    glUseProgram(shader);
 
     // ===================== PRAGOVI ======================
 
@@ -237,15 +371,21 @@ void drawTrack(GLuint shader, GLuint vaoTrack, GLuint vaoQuad)      //SINE
     glUniform3f(locColor, 0.45f, 0.30f, 0.15f);  // braonkasti pragovi
     glUniform1f(locAngle, 0.0f);   // da ne rotiramo kvadrat pragova
 
-    // svakih ~6% putanje jedan prag
-    for (float t = 0.0f; t <= 0.97f; t += 0.06f)
-    {
-        Vec2 p = sampleTrack(t, trackPoints, TRACK_SEGMENTS);
+    // svakih ~6% putanje jedan prag - sve pozicije odjednom
+    const int MAX_TIES = 32;
+    static const SimdLevel simd = detectSimdLevel();
+    float tieT[MAX_TIES], tieX[MAX_TIES], tieY[MAX_TIES];
+    int numTies = 0;
+    for (float t = 0.0f; t <= 0.97f && numTies < MAX_TIES; t += 0.06f)
+        tieT[numTies++] = arcLengthToT(t * track.totalLength, track);
+    sampleTrackBatch(simd, track, tieT, numTies, tieX, tieY, nullptr, nullptr);
 
+    for (int i = 0; i < numTies; ++i)
+    {
         // malo spusti prag ispod centra sine
-        float y = p.y - 0.035f;
+        float y = tieY[i] - 0.035f;
 
-        glUniform2f(locPos, p.x, y);
+        glUniform2f(locPos, tieX[i], y);
         glUniform2f(locScale, 0.08f, 0.01f);  // sirina, visina
 
         glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
@@ -253,7 +393,7 @@ void drawTrack(GLuint shader, GLuint vaoTrack, GLuint vaoQuad)      //SINE
 }
 
 // vagon + sedista + ljudi
-void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
+void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad, TrackPhase phase)
 {
     glUseProgram(shader);
     glBindVertexArray(vaoQuad);
@@ -267,22 +407,21 @@ void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
     glUniform1i(locMode, 1);  // blago osvetljenje na svemu
 
     // ===================== POZICIJA VAGONA + ugao ======================
-    Vec2 p = sampleTrack(wagonT, trackPoints, TRACK_SEGMENTS);  // pozicija na sini
-    float angle = trackAngle(wagonT, trackPoints, TRACK_SEGMENTS);      //ugao tangente
-    float drawAngle = angle;        //ugao za vagon
-    if (rideState == RideState::RETURNING && p.y < -0.25f) {    // ako se vraca i nalazi se dole na donjoj stazi (y dosta nisko), okreni ga za 180 stepeni
-        drawAngle += (float)M_PI;
+    float trackT = phaseToT(phase, track);   // predjeni put -> t na putanji
+    TrackFrame frame = splineFrame(trackSpline, trackTToSplinePos(trackT, track, trackSpline.numCtrl));
+    Vec2 p = frame.pos;             // pozicija na sini
+
+    Vec2 tangent = frame.tangent;   // (cos(angle), sin(angle)) - vec izracunato pri pravljenju staze
+    Vec2 drawDir = tangent;         //pravac za vagon
+    if (ride.state == RideState::RETURNING && p.y < -0.25f) {    // ako se vraca i nalazi se dole na donjoj stazi (y dosta nisko), okreni ga za 180 stepeni
+        drawDir.x = -drawDir.x;
+        drawDir.y = -drawDir.y;
     }
 
-    glUniform1f(locAngle, drawAngle);
+    // sejder i dalje prima ugao, pa samo za njega jedan atan2
+    glUniform1f(locAngle, std::atan2(drawDir.y, drawDir.x));
 
-    Vec2 tangent;
-    tangent.x = std::cos(angle);    //tangent ugao = angle -> tangent = (cos(angle), sin(angle))
-    tangent.y = std::sin(angle);
-
-    Vec2 normal;                    // normalni vektor na sinu     //normal = tangent rotiran za +90°: (-sin, cos)
-    normal.x = -std::sin(angle);
-    normal.y = std::cos(angle);
+    Vec2 normal = frame.normal;     // normalni vektor na sinu     //normal = tangent rotiran za +90°: (-sin, cos)
 
     // ako normal gleda nadole, okreni je – vagon ce uvek biti "gore"
     if (normal.y < 0.0f) {
@@ -300,12 +439,12 @@ void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
     // glavno telo (crveno)
     glUniform3f(locColor, 0.85f, 0.15f, 0.15f);     //boja
     glUniform2f(locPos, center.x, center.y);            //pozicija
-    glUniform2f(locScale, 0.28f, 0.12f);            //velicina - sirina, visina
+    glUniform2f(locScale, WAGON_WIDTH, WAGON_HEIGHT);            //velicina - sirina, visina
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
     // ===================== SEDISTA ======================
-    float cosA = std::cos(drawAngle);
-    float sinA = std::sin(drawAngle);
+    float cosA = drawDir.x;
+    float sinA = drawDir.y;
 
     glUniform3f(locColor, 0.65f, 0.65f, 0.70f);
 
@@ -332,7 +471,7 @@ void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
     // ===================== PUTNICI ======================
     for (int i = 0; i < MAX_SEATS; ++i)
     {
-        if (!passengers[i].present) continue;
+        if (!ride.passengers[i].present) continue;
 
         // Rotiraj lokalni offset sedista       //lad se okrene vagon da se i oni okrenu
         float localX = seatOffsets[i].x;
@@ -353,7 +492,7 @@ void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
         float teloRotY = teloOffset.x * sinA + teloOffset.y * cosA;
 
         // boja tela: plavo normalno, zeleno ako je sick
-        if (passengers[i].sick)
+        if (ride.passengers[i].sick)
             glUniform3f(locColor, 0.10f, 0.70f, 0.20f);   // "muka" – zelenkast
         else
             glUniform3f(locColor, 0.12f, 0.30f, 0.95f);   // normalno plavo
@@ -368,7 +507,7 @@ void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
         float glavaRotY = glavaOffset.x * sinA + glavaOffset.y * cosA;
 
         // boja glave: bela normalno, zeleno ako je sick
-        if (passengers[i].sick)
+        if (ride.passengers[i].sick)
             glUniform3f(locColor, 0.10f, 0.70f, 0.20f);   // "muka" – zelenkast
         else
             glUniform3f(locColor, 0.98f, 0.90f, 0.75f);   // normalno belo
@@ -379,7 +518,7 @@ void drawWagonAndPassengers(GLuint shader, GLuint vaoQuad)
         glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
         // ================== POJAS (ako je vezan) ==================
-        if (passengers[i].beltOn)
+        if (ride.passengers[i].beltOn)
         {
             Vec2 pojasOffset = { 0.0f, 0.02f };          // pojas ide preko stomaka, malo ispod tela
             float pojasRotX = pojasOffset.x * cosA - pojasOffset.y * sinA;
@@ -451,6 +590,8 @@ int main()
     // Sejder
     GLuint basicShader = createShader("basic.vert", "basic.frag");
     if (!basicShader) return endProgram("Neuspeh pri kreiranju sejdera.");
+    GLuint trackShader = createShader("track.vert", "basic.frag");   // sine (SoA x / y)
+    if (!trackShader) return endProgram("Neuspeh pri kreiranju sejdera.");
     glLineWidth(5.0f);   // sine deblje
 
     glUseProgram(basicShader);
@@ -467,21 +608,96 @@ int main()
         std::cout << "Kursor nije ucitan! Putanja: res/rails.png\n";
     }
 
-    // Pravimo putanju
-    buildTrack(trackPoints, TRACK_SEGMENTS, ctrlPoints, NUM_CTRL);
+    // Pravimo putanju - ili je uzimamo gotovu iz fajla (mapiran, bez racunanja i kopiranja)
+    // (fajl napravljen od drugog rasporeda ili sa drugim podesavanjima se odbacuje i pravi ponovo)
+    bool trackFromFile = false;
+    const TrackBuildKey buildKey = currentTrackBuildKey();
+    if (TRACK_MODE != TrackMode::Baked && openTrackFile(trackFile, TRACK_FILE, buildKey)) {
+        ctrlPoints.assign(trackFile.ctrlPoints, trackFile.ctrlPoints + trackFile.header->numCtrl);
+        attachTrackFile(track, trackFile);
+        trackFromFile = true;
+    }
+
+    // raspored iz TRACK_LAYOUT_FILE: tacke idu u krivu dok se fajl cita (ugradjena staza ima fiksan raspored)
+    bool layoutFromFile = false;
+    if (!trackFromFile && TRACK_MODE != TrackMode::Baked) {
+        std::vector<Vec2> loaded;
+        TrackSplineStream stream;
+        beginTrackSpline(stream, trackSpline);
+        layoutFromFile = streamControlPoints(TRACK_LAYOUT_FILE, layoutFormatFromPath(TRACK_LAYOUT_FILE),
+            [&](Vec2 p) {
+                loaded.push_back(p);
+                addTrackSplinePoint(stream, p);
+            }) && endTrackSpline(stream);
+
+        if (layoutFromFile) {
+            ctrlPoints.swap(loaded);
+            std::cout << "Raspored ucitan iz " << TRACK_LAYOUT_FILE << ": " << ctrlPoints.size() << " kontrolnih tacaka\n";
+        }
+    }
+    if (!trackFromFile && !layoutFromFile && TRACK_MODE != TrackMode::Baked && GENERATED_LAYOUT_POINTS > 0) {
+        LayoutParams params;
+        params.seed = GENERATED_LAYOUT_SEED;
+        params.numCtrl = GENERATED_LAYOUT_POINTS;
+        if (!generateLayout(ctrlPoints, params))
+            std::cout << "Generisan raspored prelazi granicu zakrivljenosti.\n";
+        std::cout << "Raspored generisan (seed " << GENERATED_LAYOUT_SEED << "): " << ctrlPoints.size() << " kontrolnih tacaka\n";
+    }
+    if (!layoutFromFile && !buildTrackSpline(trackSpline, ctrlPoints.data(), (int)ctrlPoints.size()))
+        return endProgram("Staza nije napravljena.");
+
+    // malu stazu brze napravi jedna nit nego sto se niti pokrenu
+    const int buildThreads = ((int)ctrlPoints.size() >= PARALLEL_BUILD_MIN_CTRL) ? 0 : 1;
+    if (trackFromFile) {
+        std::cout << "Staza ucitana iz " << TRACK_FILE << "\n";
+    }
+    else if (TRACK_MODE == TrackMode::Baked) {
+        attachLayoutTrack<TRACK_MODE>(track);
+    }
+    else if (TRACK_MODE == TrackMode::Adaptive) {
+        // ista tacnost kao 400 ravnomernih tacaka, a oko pola manje temena
+        if (!buildTrackAdaptive(track, trackSpline, TRACK_TOLERANCE,
+                TRACK_TANGENTS | TRACK_ARC_LENGTH | TRACK_PARAM | TRACK_CURVATURE, buildThreads))
+            return endProgram("Staza nije napravljena.");
+    }
+    else {
+        // veliki raspored iz fajla: bar 4 tacke po rasponu
+        int segments = std::max(TRACK_SEGMENTS, (int)ctrlPoints.size() * 4 + 1);
+        if (!allocateTrack(track, segments, TRACK_TANGENTS | TRACK_ARC_LENGTH | TRACK_CURVATURE))
+            return endProgram("Staza nije napravljena.");
+        buildTrack(track, trackSpline, buildThreads);
+    }
+    // sledece pokretanje samo mapira fajl
+    if (!trackFromFile && TRACK_MODE != TrackMode::Baked)
+        writeTrackFile(TRACK_FILE, track, ctrlPoints.data(), (int)ctrlPoints.size(), buildKey);
+    std::cout << "Staza: " << track.count << " tacaka, duzina " << track.totalLength << "\n";
+    buildTrackIndex(trackIndex, track);
+    trackIndexDirty = false;
+    buildTrackProfile(trackProfile, track, trackSpline);
 
 
     // ============== VAO za sine ==============
-    GLuint vaoTrack, vboTrack;
+    GLuint vaoTrack, vboTrack, eboTrack;
     glGenVertexArrays(1, &vaoTrack);
     glGenBuffers(1, &vboTrack);
-
-    glBindVertexArray(vaoTrack);
-    glBindBuffer(GL_ARRAY_BUFFER, vboTrack);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(trackPoints), trackPoints, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2), (void*)0);
-    glEnableVertexAttribArray(0);
+    glGenBuffers(1, &eboTrack);
+
+    if (!TRACK_QUANTIZED)
+        uploadTrack(vaoTrack, vboTrack);
+    uploadTrackLod(vaoTrack, eboTrack);
+
+    // ============== Sabijene sine (16 bita) ==============
+    QuantRailsGpu quantRails;
+    if (TRACK_QUANTIZED) {
+        quantRails.shader = createShader("track_q.vert", "basic.frag");
+        glGenVertexArrays(1, &quantRails.vao);
+        glGenBuffers(1, &quantRails.vbo);
+        glGenBuffers(1, &quantRails.chunkBuffer);
+        glGenTextures(1, &quantRails.chunkTex);
+        size_t quantBytes = uploadQuantTrack(quantRails, eboTrack);
+        std::cout << "Sabijene sine na GPU-u: " << quantBytes << " B (umesto "
+            << (size_t)track.count * 2 * sizeof(float) << " B)\n";
+    }
 
     // ============== VAO za kvadrat (vagon, sedista, putnici) ==============
     float quadVerts[] = {
@@ -554,6 +770,7 @@ int main()
     glClearColor(0.4f, 0.5f, 0.95f, 1.0f);
 
     double lastTime = glfwGetTime();    //  vreme za dt
+    double simAccumulator = 0.0;        //  vreme koje jos nije odsimulirano (< SIM_STEP posle petlje)
 	const double TARGET_FRAME_TIME = 1.0 / 75.0;  // 75 FPS         //FRAME LIMITER
 
 
@@ -577,37 +794,15 @@ int main()
 
         int spaceState = glfwGetKey(window, GLFW_KEY_SPACE);
         if (spaceState == GLFW_PRESS && !spaceWasPressed) {
-            if (rideState == RideState::BOARDING && !clearingPassengers) {
-                addPassenger();
-            }
+            addPassenger(ride);   // samo u ukrcavanju
         }
         spaceWasPressed = (spaceState == GLFW_PRESS);
 
         // --- input: ENTER start/stop voznje ---
         int enterState = glfwGetKey(window, GLFW_KEY_ENTER);
         if (enterState == GLFW_PRESS && !enterWasPressed) {
-            if (rideState == RideState::BOARDING && !clearingPassengers) {
-				bool allSafe = true;            //pokusaj da krene voznja, proveravmo pojaseve
-                for (int i = 0; i < MAX_SEATS; ++i) {
-                    if (passengers[i].present && !passengers[i].beltOn) {
-                        allSafe = false;
-                        break;
-                    }
-                }
-                if (allSafe && passengerCount > 0) {
-                    rideState = RideState::ACCELERATING;
-                    wagonSpeed = 0.0f;
-                }
-                else {
-                    std::cout << "Neko nema vezan pojas ili nema putnika – voznja ne krece.\n";
-                }
-            }
-            else {
-                // hard stop – odmah zaustavi voznju gde god da je
-                wagonSpeed = 0.0f;
-                rideState = RideState::PAUSED_SICK;   // ili BOARDING, 
-                sickPauseTimer = 0.0;
-            }
+            if (!pressStart(ride))
+                std::cout << "Neko nema vezan pojas ili nema putnika – voznja ne krece.\n";
         }
         enterWasPressed = (enterState == GLFW_PRESS);
 
@@ -624,18 +819,76 @@ int main()
         }
         leftMouseWasPressed = (leftState == GLFW_PRESS);
 
+        // --- input: DESNI KLIK – pomeranje kontrolne tacke (samo dok se ukrcava) ---
+        int rightState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
+        if (rightState != GLFW_PRESS || ride.state != RideState::BOARDING) {
+            draggedCtrlPoint = -1;
+
+            // nivoi detalja i provera se rade tek kad se pusti tacka (dok se vuce crta se puna staza)
+            // prvi frejm je isti slucaj - staza je tek napravljena
+            if (trackTessDirty) {
+                // dok se vuce adaptivna staza ima staru podelu (isti broj tacaka), ovde nova
+                if (retessellateTrack(track, trackSpline)) {
+                    if (TRACK_QUANTIZED) uploadQuantTrack(quantRails, eboTrack);
+                    else uploadTrack(vaoTrack, vboTrack);
+                    trackIndexDirty = true;
+                }
+                trackTessDirty = false;
+            }
+            if (trackLodDirty) {
+                uploadTrackLod(vaoTrack, eboTrack);
+                reportTrackIssues();
+            }
+        }
+        else {
+            float xNdc = (float(mx) / (float)SCREEN_WIDTH) * 2.0f - 1.0f;
+            float yNdc = 1.0f - (float(my) / (float)SCREEN_HEIGHT) * 2.0f;
+
+            if (draggedCtrlPoint < 0) {
+                draggedCtrlPoint = pickControlPoint(xNdc, yNdc);
+
+                // ugradjena ili mapirana staza se samo cita - prvo kopija u sopstvenu memoriju
+                if (draggedCtrlPoint >= 0 && !track.storage) {
+                    TrackBuffer owned;
+                    if (copyTrack(owned, track))
+                        track = std::move(owned);
+                    else
+                        draggedCtrlPoint = -1;
+                }
+                lastDragX = mx;
+                lastDragY = my;
+            }
+            else if (mx != lastDragX || my != lastDragY) {
+                // menjaju se samo 4 raspona oko tacke, pa se salje samo taj deo bafera
+                TrackUpdate update = updateControlPoint(track, trackSpline, ctrlPoints.data(),
+                    draggedCtrlPoint, { xNdc / TRACK_SCALE_X, yNdc });
+                trackIndexDirty = true;
+                trackLodDirty = true;
+                trackTessDirty = track.tolerance > 0.0f;
+                trackProfileDirty = true;
+                if (update.resized) {
+                    if (TRACK_QUANTIZED) uploadQuantTrack(quantRails, eboTrack);
+                    else uploadTrack(vaoTrack, vboTrack);
+                }
+                else {
+                    for (int r = 0; r < update.numRanges; ++r) {
+                        if (TRACK_QUANTIZED) uploadQuantTrackRange(quantRails, update.ranges[r]);
+                        else uploadTrackRange(vboTrack, update.ranges[r]);
+                    }
+                }
+                lastDragX = mx;
+                lastDragY = my;
+            }
+        }
+
 
         // --- tasteri 1–8: nekome je lose ---
-        if (rideState == RideState::ACCELERATING || rideState == RideState::RUNNING) {
+        if (ride.state == RideState::ACCELERATING || ride.state == RideState::RUNNING) {
             for (int k = 0; k < MAX_SEATS; ++k) {
                 int key = GLFW_KEY_1 + k;
                 int st = glfwGetKey(window, key);
                 if (st == GLFW_PRESS) {
-                    if (passengers[k].present) {
-                        passengers[k].sick = true;
-                        sickPassengerIndex = k;
-                        rideState = RideState::STOPPING_SICK;
-                    }
+                    makeSick(ride, k);
                     break;
                 }
             }
@@ -644,19 +897,7 @@ int main()
         // --- Taster B: vezivanje / skidanje pojaseva za sve prisutne ---
         int bState = glfwGetKey(window, GLFW_KEY_B);
         if (bState == GLFW_PRESS && !bKeyWasPressed)
-        {
-            bool biloVezano = false;
-            for (int i = 0; i < MAX_SEATS; ++i)
-                if (passengers[i].present && passengers[i].beltOn)
-                    biloVezano = true;
-
-            // ako je bar jedan bio vezan -> skini sve,
-            // inace vezi sve
-            bool newState = !biloVezano;
-            for (int i = 0; i < MAX_SEATS; ++i)
-                if (passengers[i].present)
-                    passengers[i].beltOn = newState;
-        }
+            toggleAllBelts(ride);
         bKeyWasPressed = (bState == GLFW_PRESS);
 
         // --- Taster R: totalni reset cele voznje ---
@@ -667,136 +908,27 @@ int main()
         }
         rKeyWasPressed = (rState == GLFW_PRESS);
 
-        // --- kretanje vagona po sinama ---    
-        if (rideRunning) {
-            wagonT += wagonSpeed * (float)dt;
-            // ako predje kraj putanje, vracamo na pocetak (vozi u krug)
-            if (wagonT > 1.0f) wagonT -= 1.0f;
-            if (wagonT < 0.0f) wagonT += 1.0f;
-        }
-
-
-        // --- fizika voznje / brzina ---
-        if (rideState == RideState::ACCELERATING ||
-            rideState == RideState::RUNNING ||
-            rideState == RideState::STOPPING_SICK ||
-            rideState == RideState::RETURNING)
-        {
-            float angle = trackAngle(wagonT, trackPoints, TRACK_SEGMENTS);
-            float slopeY = std::sin(angle);
-
-            switch (rideState)
-            {
-            case RideState::ACCELERATING:
-                wagonSpeed += START_ACCEL * (float)dt;
-                if (wagonSpeed > TARGET_SPEED) wagonSpeed = TARGET_SPEED;
-
-                wagonT += wagonSpeed * (float)dt;
-                if (wagonT > 1.0f) wagonT -= 1.0f;
-
-                if (wagonSpeed >= TARGET_SPEED * 0.999f)
-                    rideState = RideState::RUNNING;
-                break;
-
-            case RideState::RUNNING:
-            {
-                // nagib – sin ugla; >0 = uzbrdo, <0 = nizbrdo (za nas smer putanje)
-                float slope = slopeY;
-
-                // koliko jako guramo nizbrdo / kocimo uzbrdo
-                const float DOWNHILL_ACCEL = 3.0f;  
-                const float UPHILL_BRAKE = 3.5f;   
-
-                if (slope > 0.0f) {
-                    // UZBRDO – jako usporavanje
-                    wagonSpeed -= UPHILL_BRAKE * slope * (float)dt;
-                }
-                else {
-                    // NIZBRDO – jako ubrzavanje
-                    wagonSpeed += DOWNHILL_ACCEL * (-slope) * (float)dt;
-                }
-
-                // Na skoro ravnim delovima blago vucemo brzinu ka TARGET_SPEED
-                float steepness = std::fabs(slope);                      // 0 = ravno, 1 = strmo
-                float flatness = 1.0f - std::min(1.0f, steepness * 4);  // <~0.25 = ravno
-                const float FRICTION = 1.0f;
-                wagonSpeed += (TARGET_SPEED - wagonSpeed) * flatness * FRICTION * (float)dt;
-                
-                // ogranicenja
-                if (wagonSpeed < MIN_SPEED) wagonSpeed = MIN_SPEED;
-                if (wagonSpeed > MAX_SPEED) wagonSpeed = MAX_SPEED;
-
-                float oldT = wagonT;
-
-                // pomeri vagon po putanji
-                wagonT += wagonSpeed * (float)dt;
-                if (wagonT > 1.0f) wagonT -= 1.0f;
-
-                // ako smo presli sa kraja na pocetak (oldT ~0.99, wagonT ~0.02)
-                // smatramo da je tura gotova
-                if (oldT > wagonT) {
-                    finishReturnToStart();
-                }
-
-                break;
-            }
-            case RideState::STOPPING_SICK:
-                wagonSpeed -= BRAKE_ACCEL * (float)dt;
-                if (wagonSpeed <= 0.0f) {
-                    wagonSpeed = 0.0f;
-                    rideState = RideState::PAUSED_SICK;
-                    sickPauseTimer = 0.0;
-                }
-                else {
-                    wagonT += wagonSpeed * (float)dt;
-                    if (wagonT > 1.0f) wagonT -= 1.0f;
-                }
-                break;
-
-            case RideState::RETURNING:
-
-                if (returningForward) {
-                    // idemo napred ka t = 1.0 pa wrap na 0
-                    wagonT += RETURN_SPEED * (float)dt;
-
-                    if (wagonT >= 1.0f) {
-                        finishReturnToStart();   // postavi t=0 i odvezi sve
-                    }
-                }
-                else {
-                    // idemo unazad ka t = 0.0
-                    wagonT -= RETURN_SPEED * (float)dt;
-
-                    if (wagonT <= 0.0f) {
-                        finishReturnToStart();
-                    }
-                }
-                break;
-
-            default:
-                break;
-            }
-        }
-        if (rideState == RideState::PAUSED_SICK) {
-            sickPauseTimer += dt;
-            if (sickPauseTimer >= PAUSE_DURATION) {
-                // izaberi smer koji je kraci do pocetka
-                float distBack = wagonT;           // od t do 0 unazad
-                float distFwd = 1.0f - wagonT;    // od t do 1 unapred (pa wrap na 0)
-
-                returningForward = (distFwd < distBack);  // true = idemo napred ka 1
-
-                rideState = RideState::RETURNING;
+        // --- simulacija: fiksni koraci za proteklo vreme, crtanje interpolira izmedju poslednja dva ---
+        simAccumulator += std::min(dt, MAX_FRAME_TIME);
+        while (simAccumulator >= SIM_STEP) {
+            // dok se ukrcava voz stoji i profil se ne cita - pravi se jednom, kad voznja krene
+            if (trackProfileDirty && ride.state != RideState::BOARDING) {
+                buildTrackProfile(trackProfile, track, trackSpline);
+                trackProfileDirty = false;
             }
+            stepRide(ride, trackProfile, rideParams, SIM_STEP);
+            simAccumulator -= SIM_STEP;
         }
+        const double simAlpha = simAccumulator / SIM_STEP;
+        const TrackPhase renderPhase = interpolatePhase(ride, simAlpha);
 
         // --- crtanje ---
         glClear(GL_COLOR_BUFFER_BIT);
 
         drawBackground(basicShader, vaoQuad);
     
-        drawTrack(basicShader, vaoTrack, vaoQuad);
-        drawWagonAndPassengers(basicShader, vaoQuad);
+        drawTrack(basicShader, trackShader, vaoTrack, vaoQuad, quantRails);
+        drawWagonAndPassengers(basicShader, vaoQuad, renderPhase);
 
         // --- overlay sa imenom, prezimenom, indeksom ---
         glDisable(GL_DEPTH_TEST);  // da overlay bude sigurno preko svega
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// ================== Slucajni brojevi (splitmix64) ==================
+// Mali, brz i isti niz na svakom kompajleru i platformi (std:: distribucije nisu), pa isti
+// seed daje isti generisan raspored i iste voznje svuda. Stanje je jedan uint64_t.
+
+inline uint64_t nextRandom(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// [0, 1), svih 53 bita
+inline double randomUnit(uint64_t& state)
+{
+    return (double)(nextRandom(state) >> 11) / 9007199254740992.0;
+}
@@ -0,0 +1,251 @@
+#include "Ride.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ================== Reset putnika i svega ==================
+void resetPassengers(Ride& ride)
+{
+    ride.passengerCount = 0;
+    for (int i = 0; i < MAX_SEATS; ++i) {
+        ride.passengers[i].present = false;
+        ride.passengers[i].beltOn = false;
+        ride.passengers[i].sick = false;
+    }
+}
+
+void resetRide(Ride& ride)
+{
+    // polozaj i brzina
+    ride.phase = 0;
+    ride.prevPhase = 0;
+    ride.speed = 0.0f;
+
+    // stanje voznje
+    ride.state = RideState::BOARDING;
+    ride.clearingPassengers = false;
+    ride.sickPauseTimer = 0.0;
+    ride.sickPassengerIndex = -1;
+
+    // putnici
+    resetPassengers(ride);
+}
+
+void finishReturnToStart(Ride& ride)
+{
+    // skok na start - bez interpolacije preko cele staze
+    ride.phase = 0;
+    ride.prevPhase = 0;
+    ride.speed = 0.0f;
+
+    // automatski odvezi sve putnike i izleci ih
+    for (int i = 0; i < MAX_SEATS; ++i) {
+        if (ride.passengers[i].present) {
+            ride.passengers[i].beltOn = false;
+            ride.passengers[i].sick = false;
+        }
+    }
+
+    ride.sickPassengerIndex = -1;
+    ride.clearingPassengers = true;       // klik izbacuje putnike
+    ride.state = RideState::BOARDING; // opet stanje ukrcavanja
+    ++ride.finishedRides;
+}
+
+// ================== Ulazi ==================
+bool addPassenger(Ride& ride)
+{
+    if (ride.state != RideState::BOARDING || ride.clearingPassengers) return false;
+    if (ride.passengerCount >= MAX_SEATS) return false; // pun vagon
+
+    for (int i = 0; i < MAX_SEATS; ++i) {
+        if (!ride.passengers[i].present) {
+            ride.passengers[i].present = true;
+            ride.passengers[i].beltOn = false;
+            ride.passengers[i].sick = false;
+            ride.passengerCount++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void clickSeat(Ride& ride, int seat)
+{
+    Passenger& p = ride.passengers[seat];
+    if (!p.present) return;   // prazno sediste nas ne zanima
+
+    if (ride.clearingPassengers) {
+        // posle povratka – klik izbacuje putnika
+        p.present = false;
+        p.beltOn = false;
+        p.sick = false;
+        ride.passengerCount--;
+        if (ride.passengerCount <= 0) {
+            ride.clearingPassengers = false; // sad moze nova tura
+        }
+    }
+    else if (ride.state == RideState::BOARDING) {
+        // normalno stanje – klik kaci/otkaci pojas
+        p.beltOn = !p.beltOn;
+    }
+}
+
+void toggleAllBelts(Ride& ride)
+{
+    bool biloVezano = false;
+    for (int i = 0; i < MAX_SEATS; ++i)
+        if (ride.passengers[i].present && ride.passengers[i].beltOn)
+            biloVezano = true;
+
+    // ako je bar jedan bio vezan -> skini sve,
+    // inace vezi sve
+    bool newState = !biloVezano;
+    for (int i = 0; i < MAX_SEATS; ++i)
+        if (ride.passengers[i].present)
+            ride.passengers[i].beltOn = newState;
+}
+
+bool pressStart(Ride& ride)
+{
+    if (ride.state == RideState::BOARDING) {
+        if (ride.clearingPassengers) return false;
+
+        bool allSafe = true;            //pokusaj da krene voznja, proveravmo pojaseve
+        for (int i = 0; i < MAX_SEATS; ++i) {
+            if (ride.passengers[i].present && !ride.passengers[i].beltOn) {
+                allSafe = false;
+                break;
+            }
+        }
+        if (!allSafe || ride.passengerCount <= 0) return false;
+
+        ride.state = RideState::ACCELERATING;
+        ride.speed = 0.0f;
+        return true;
+    }
+
+    // hard stop – odmah zaustavi voznju gde god da je
+    ride.speed = 0.0f;
+    ride.state = RideState::PAUSED_SICK;
+    ride.sickPauseTimer = 0.0;
+    return true;
+}
+
+bool makeSick(Ride& ride, int seat)
+{
+    if (ride.state != RideState::ACCELERATING && ride.state != RideState::RUNNING) return false;
+    if (!ride.passengers[seat].present) return false;
+
+    ride.passengers[seat].sick = true;
+    ride.sickPassengerIndex = seat;
+    ride.state = RideState::STOPPING_SICK;
+    return true;
+}
+
+// ================== Simulacija voznje (fiksan korak) ==================
+void stepRide(Ride& ride, const TrackProfile& profile, const RideParams& params, double dt)
+{
+    ride.prevPhase = ride.phase;
+
+    if (ride.state == RideState::ACCELERATING ||
+        ride.state == RideState::RUNNING ||
+        ride.state == RideState::STOPPING_SICK ||
+        ride.state == RideState::RETURNING)
+    {
+        // jedno citanje profila: sin ugla nagiba (y komponenta jedinicne tangente)
+        float slopeY = sampleProfile(profile, ride.phase).slope;
+
+        switch (ride.state)
+        {
+        case RideState::ACCELERATING:
+            ride.speed += params.startAccel * (float)dt;
+            if (ride.speed > params.targetSpeed) ride.speed = params.targetSpeed;
+
+            ride.phase += phaseStep(ride.speed * dt, profile.totalLength);
+
+            if (ride.speed >= params.targetSpeed * 0.999f)
+                ride.state = RideState::RUNNING;
+            break;
+
+        case RideState::RUNNING:
+        {
+            // nagib – sin ugla; >0 = uzbrdo, <0 = nizbrdo (za nas smer putanje)
+            float slope = slopeY;
+
+            if (slope > 0.0f) {
+                // UZBRDO – jako usporavanje
+                ride.speed -= params.gravityAccel * params.uphillBrake * slope * (float)dt;
+            }
+            else {
+                // NIZBRDO – jako ubrzavanje
+                ride.speed += params.gravityAccel * params.downhillAccel * (-slope) * (float)dt;
+            }
+
+            // Na skoro ravnim delovima blago vucemo brzinu ka targetSpeed
+            float steepness = std::fabs(slope);                      // 0 = ravno, 1 = strmo
+            float flatness = 1.0f - std::min(1.0f, steepness * 4);  // <~0.25 = ravno
+            ride.speed += (params.targetSpeed - ride.speed) * flatness * params.friction * (float)dt;
+            
+            // ogranicenja
+            if (ride.speed < params.minSpeed) ride.speed = params.minSpeed;
+            if (ride.speed > params.maxSpeed) ride.speed = params.maxSpeed;
+
+            uint32_t lap = phaseLaps(ride.phase);
+
+            // pomeri vagon po putanji
+            ride.phase += phaseStep(ride.speed * dt, profile.totalLength);
+
+            // presli smo sa kraja na pocetak (promenio se broj krugova) - tura je gotova
+            if (phaseLaps(ride.phase) != lap) {
+                finishReturnToStart(ride);
+            }
+
+            break;
+        }
+        case RideState::STOPPING_SICK:
+            ride.speed -= params.brakeAccel * (float)dt;
+            if (ride.speed <= 0.0f) {
+                ride.speed = 0.0f;
+                ride.state = RideState::PAUSED_SICK;
+                ride.sickPauseTimer = 0.0;
+            }
+            else {
+                ride.phase += phaseStep(ride.speed * dt, profile.totalLength);
+            }
+            break;
+
+        case RideState::RETURNING:
+        {
+            // i napred (preko kraja) i unazad (preko pocetka) se stize na start kad se promeni krug
+            uint32_t lap = phaseLaps(ride.phase);
+            TrackPhase step = phaseStep(params.returnSpeed * dt, profile.totalLength);
+
+            if (ride.returningForward)
+                ride.phase += step;     // idemo napred ka kraju pa na pocetak
+            else
+                ride.phase -= step;     // idemo unazad ka pocetku
+
+            if (phaseLaps(ride.phase) != lap) {
+                finishReturnToStart(ride);   // postavi polozaj na 0 i odvezi sve
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+    if (ride.state == RideState::PAUSED_SICK) {
+        ride.sickPauseTimer += dt;
+        if (ride.sickPauseTimer >= PAUSE_DURATION) {
+            // izaberi smer koji je kraci do pocetka
+            double distBack = phaseFraction(ride.phase);   // do pocetka unazad
+            double distFwd = 1.0 - distBack;               // do kraja unapred (pa na pocetak)
+
+            ride.returningForward = (distFwd < distBack);  // true = idemo napred ka 1
+
+            ride.state = RideState::RETURNING;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "Helpers.h"
+#include "TrackPhase.h"
+#include "TrackProfile.h"
+
+#include <cmath>
+#include <cstdint>
+
+// ================== Voznja (bez prozora i crtanja) ==================
+// Stanje vagona i putnika i prelazi od ukrcavanja do povratka na start. Ulazi (tasteri, klik)
+// su obicne funkcije, pa istu voznju pokrecu i prozor (Main.cpp) i RideHeadless bez ekrana.
+
+const int MAX_SEATS = 8;
+
+const double PAUSE_DURATION = 10.0;   // pauza kad je nekome lose (s)
+const double SIM_STEP = 1.0 / 240.0;     // korak simulacije voznje (s)
+
+// brzine (jedinice po sekundi, mereno duz sine) - menjaju se bez prevodjenja (npr. RideSweep)
+struct RideParams {
+    float startAccel = 4.1f;      // ubrzanje pri startu
+    float targetSpeed = 1.2f;     // bazna brzina na ravnom
+    float gravityAccel = 1.0f;    // koliko nagib utice (mnozi downhillAccel i uphillBrake)
+    float minSpeed = 0.22f;
+    float maxSpeed = 3.3f;
+    float brakeAccel = 2.2f;      // kocenje kad je nekome lose
+    float returnSpeed = 0.33f;    // mala brzina ka pocetku
+    float downhillAccel = 16.5f;  // koliko jako guramo nizbrdo
+    float uphillBrake = 19.0f;    // koliko jako kocimo uzbrdo
+    float friction = 1.0f;        // vucenje ka targetSpeed na ravnom
+};
+
+struct Passenger {
+    bool present;  // da li sedi
+    bool beltOn;
+    bool sick;     // tasteri 1-8
+};
+
+enum class RideState {   // stanje voznje
+    BOARDING,        // dodavanje putnika / vezivanje pojaseva
+    ACCELERATING,    // ubrzava posle ENTER-a
+    RUNNING,         // normalna voznja
+    STOPPING_SICK,   // koci jer je nekome lose
+    PAUSED_SICK,     // stoji 10 s
+    RETURNING        // vraca se ka pocetku malom brzinom
+};
+
+struct Ride {
+    Passenger  passengers[MAX_SEATS] = {};
+    int        passengerCount = 0;
+    TrackPhase phase = 0;           // polozaj na stazi (krugovi + deo kruga), 0 = pocetak putanje
+    TrackPhase prevPhase = 0;       // polozaj pre poslednjeg koraka (crta se izmedju njih)
+    float      speed = 0.0f;        // brzina po putanji (jedinica u sekundi)
+    RideState  state = RideState::BOARDING;
+    bool       clearingPassengers = false;  // posle povratka klik skida putnike
+    double     sickPauseTimer = 0.0;
+    int        sickPassengerIndex = -1;
+    bool       returningForward = false;
+    int        finishedRides = 0;   // koliko tura se vratilo na start (statistika)
+};
+
+// Sve na pocetak (taster R)
+void resetRide(Ride& ride);
+void resetPassengers(Ride& ride);
+
+// Vagon je stigao na start: polozaj 0, pojasevi skinuti, klik na sediste sada izbacuje putnika
+void finishReturnToStart(Ride& ride);
+
+// Space: novi putnik na prvo slobodno mesto (samo u ukrcavanju); false ako nije seo
+bool addPassenger(Ride& ride);
+
+// Klik na sediste: u ukrcavanju kaci/otkaci pojas, posle povratka izbacuje putnika
+void clickSeat(Ride& ride, int seat);
+
+// B: ako je bar jedan pojas vezan - skini sve, inace vezi sve
+void toggleAllBelts(Ride& ride);
+
+// ENTER: u ukrcavanju krece ako svi imaju pojas (false ako ne), tokom voznje staje odmah
+bool pressStart(Ride& ride);
+
+// Tasteri 1-8: putniku je lose - vagon koci (samo dok ubrzava ili vozi)
+bool makeSick(Ride& ride, int seat);
+
+// Jedan korak simulacije od dt sekundi (brzina, polozaj, prelazi stanja)
+void stepRide(Ride& ride, const TrackProfile& profile, const RideParams& params, double dt);
+
+// Polozaj za crtanje izmedju poslednja dva koraka (alpha u [0,1))
+inline TrackPhase interpolatePhase(const Ride& ride, double alpha)
+{
+    return ride.prevPhase + (TrackPhase)(int64_t)std::llround((double)(int64_t)(ride.phase - ride.prevPhase) * alpha);
+}
@@ -0,0 +1,587 @@
+// ================== Voznja bez prozora ==================
+// Ista voznja kao u Main.cpp (Ride.cpp), bez GLFW-a i bez ogranicenja na 75 FPS: koraci od
+// SIM_STEP se vrte koliko procesor stigne. Ulazi dolaze iz skripte ili od ugradjenog operatera.
+//
+//   RideHeadless [--layout fajl] [--generate tacaka seed] [--script fajl] [--hours h] [--seed s]
+//                [--runs n] [--threads t] [--sweep opis --out fajl.csv [--samples n]] [--trains n]
+//                [--graph ivica] [--simd-check uzoraka] [--quant-check]
+//
+// Skripta: jedna komanda po liniji "vreme komanda [sediste]", vreme u sekundama od pocetka,
+// linije poredjane po vremenu, # je komentar. Komande: board, belts, start, seat N (klik na
+// sediste 1-8), sick N (1-8), reset. Bez skripte operater ukrcava, vezuje, pusta i iskrcava
+// ture do kraja radnog dana (--hours, podrazumevano 12). Sa --runs se pravi n nezavisnih
+// perioda od --hours sati na svim jezgrima (RideMonteCarlo) i ispisuje kapacitet. Sa --sweep
+// se RideParams pretrazuju po mrezi (ili LHS sa --samples) i rezultati idu u CSV (RideSweep).
+// Sa --trains se n vozova, svaki sa svojim operaterom, vozi zajedno (TrainWorld) --hours sati
+// (podrazumevano 1 minut) i ispisuje koliko traje jedan korak svih vozova. Sa --graph se pravi
+// mreza pruga sa toliko ivica (--seed) jednom niti i na --threads niti, i proverava da su tabele iste,
+// pa se vozi kroz skretnicu u oba polozaja, unazad i do branika.
+// Sa --simd-check se toliko slucajnih t (i ivicne vrednosti) uzorkuje sa sampleTrackBatch na svakom
+// nivou koji procesor ima i poredi bit po bit sa skalarnom verzijom i sa sampleTrackFrame.
+// Sa --quant-check se staza sabija kao za GPU (TrackQuant) i svaka dekodirana tacka poredi sa
+// float stazom (najvise pola koraka dela), a delovi sabijeni posebno sa celom sabijenom stazom.
+//
+// Linux:  g++ -std=c++17 -O2 -pthread -I. RideHeadless.cpp Ride.cpp Helpres.cpp TrackSimd.cpp
+//         TrackProfile.cpp TrackQuant.cpp TrackLayout.cpp TrackGenerator.cpp TrackGraph.cpp RideOperator.cpp
+//         RideMonteCarlo.cpp RideSweep.cpp TrainWorld.cpp -o ride_headless
+
+#include "Ride.h"
+#include "RideOperator.h"
+#include "RideMonteCarlo.h"
+#include "RideSweep.h"
+#include "TrainWorld.h"
+#include "Helpers.h"
+#include "TrackLayout.h"
+#include "TrackGenerator.h"
+#include "TrackGraph.h"
+#include "TrackProfile.h"
+#include "TrackQuant.h"
+#include "TrackSimd.h"
+#include "WorkStealing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const float TRACK_TOLERANCE = 0.0003f;   // kao adaptivna staza u Main.cpp
+
+struct ScriptCommand {
+    double      time;
+    std::string name;
+    int         seat;      // 0-7, -1 ako komanda nema sediste
+};
+
+static bool loadScript(const char* path, std::vector<ScriptCommand>& commands)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+
+        std::istringstream ls(line);
+        ScriptCommand c;
+        if (!(ls >> c.time)) continue;   // prazna linija
+        if (!(ls >> c.name)) {
+            std::cout << path << ":" << lineNo << ": nema komande\n";
+            return false;
+        }
+        int seat = 0;
+        c.seat = (ls >> seat) ? seat - 1 : -1;
+        if ((c.name == "seat" || c.name == "sick") && (c.seat < 0 || c.seat >= MAX_SEATS)) {
+            std::cout << path << ":" << lineNo << ": sediste mora biti 1-" << MAX_SEATS << "\n";
+            return false;
+        }
+        if (!commands.empty() && c.time < commands.back().time) {
+            std::cout << path << ":" << lineNo << ": komande nisu poredjane po vremenu\n";
+            return false;
+        }
+        commands.push_back(c);
+    }
+    return true;
+}
+
+static void runCommand(Ride& ride, const ScriptCommand& c, RideStats& stats)
+{
+    if (c.name == "board") {
+        if (addPassenger(ride)) ++stats.passengersBoarded;
+    }
+    else if (c.name == "belts") toggleAllBelts(ride);
+    else if (c.name == "seat") clickSeat(ride, c.seat);
+    else if (c.name == "start") {
+        bool wasBoarding = ride.state == RideState::BOARDING;
+        if (!pressStart(ride)) ++stats.refusedStarts;
+        else if (!wasBoarding) ++stats.hardStops;
+    }
+    else if (c.name == "sick") {
+        if (makeSick(ride, c.seat)) ++stats.sickStops;
+    }
+    else if (c.name == "reset") resetRide(ride);
+    else std::cout << "Nepoznata komanda u " << c.time << " s: " << c.name << "\n";
+}
+
+// Prsten od "numEdges" ivica izmedju cvorova na krugu; svaki cvor je i skretnica ka tetivi
+// preko sredine. Ivice imaju razlicit broj tacaka (2-64), kao prava mreza.
+static void makeTestGraph(TrackGraph& graph, int numEdges, uint64_t seed)
+{
+    uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+    auto next = [&]() {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        return (float)(state >> 40) / (float)(1u << 24);
+    };
+
+    const int numNodes = std::max(2, numEdges / 2);
+    for (int k = 0; k < numNodes; ++k) {
+        float a = 6.2831853f * (float)k / (float)numNodes;
+        addTrackNode(graph, { 0.8f * std::cos(a), 0.8f * std::sin(a) });
+    }
+    for (int k = 0; k < numEdges; ++k) {
+        int from = k % numNodes;
+        int to = (k < numNodes) ? (from + 1) % numNodes : (from + numNodes / 2) % numNodes;
+        Vec2 a = graph.nodes[from].pos, b = graph.nodes[to].pos;
+
+        std::vector<Vec2> inner(2 + (int)(next() * 62.0f));
+        for (size_t i = 0; i < inner.size(); ++i) {
+            float f = (float)(i + 1) / (float)(inner.size() + 1);
+            inner[i] = { a.x + (b.x - a.x) * f + 0.02f * (next() - 0.5f),
+                         a.y + (b.y - a.y) * f + 0.02f * (next() - 0.5f) };
+        }
+        addTrackEdge(graph, from, to, inner.data(), (int)inner.size());
+    }
+}
+
+static bool sameArray(const float* a, const float* b, int n)
+{
+    return (!a && !b) || (a && b && std::memcmp(a, b, (size_t)n * sizeof(float)) == 0);
+}
+
+// voznja kroz skretnicu: A -> S pa grana 0 (ka B) ili grana 1 (ka C), unazad nazad na A, i branik.
+// Izmedju uzastopnih koraka polozaj se pomera za korak puta, a pravac se ne lomi ni na jednoj grani.
+static int checkGraphTraversal()
+{
+    TrackGraph graph;
+    const int a = addTrackNode(graph, { -0.6f, 0.0f });
+    const int s = addTrackNode(graph, { 0.0f, 0.0f });
+    const int b = addTrackNode(graph, { 0.6f, 0.1f });
+    const int c = addTrackNode(graph, { 0.5f, -0.5f });
+    const Vec2 innerA[] = { { -0.3f, 0.02f } };
+    const Vec2 innerB[] = { { 0.3f, 0.03f } };
+    const Vec2 innerC[] = { { 0.2f, -0.1f }, { 0.4f, -0.3f } };
+    const int trunk = addTrackEdge(graph, a, s, innerA, 1);
+    const int toB = addTrackEdge(graph, s, b, innerB, 1);
+    const int toC = addTrackEdge(graph, s, c, innerC, 2);
+    if (!buildTrackGraph(graph, 1)) {
+        std::cout << "Mreza nije napravljena.\n";
+        return 1;
+    }
+
+    int failed = 0;
+    auto expect = [&](bool ok, const char* what) {
+        std::printf("%-34s %s\n", what, ok ? "ok" : "GRESKA");
+        if (!ok) ++failed;
+    };
+
+    // hoda po "step" od pos "steps" puta; vraca false ako se polozaj ili pravac prekinu
+    const double step = 0.002;
+    auto walk = [&](GraphPosition pos, int steps) {
+        TrackFrame prev = sampleGraphFrame(graph, pos);
+        for (int k = 0; k < steps; ++k) {
+            if (!advanceOnGraph(graph, pos, step)) return false;
+            TrackFrame f = sampleGraphFrame(graph, pos);
+            double moved = std::hypot(f.pos.x - prev.pos.x, f.pos.y - prev.pos.y);
+            double turn = f.tangent.x * prev.tangent.x + f.tangent.y * prev.tangent.y;
+            if (moved < 0.5 * step || moved > 1.5 * step || turn < 0.99) return false;
+            prev = f;
+        }
+        return true;
+    };
+
+    const double trunkLength = graph.edges[trunk].track.totalLength;
+    GraphPosition nearSwitch;
+    nearSwitch.edge = trunk;
+    nearSwitch.s = trunkLength - 0.05;
+
+    for (int branch = 0; branch < 2; ++branch) {
+        setSwitch(graph, s, branch);
+        const int expected = branch ? toC : toB;
+        GraphPosition pos = nearSwitch;
+        bool moved = advanceOnGraph(graph, pos, 0.1);
+        expect(moved && pos.edge == expected && pos.dir == 1 && std::fabs(pos.s - 0.05) < 1e-9,
+            branch ? "Skretnica 1 -> ivica ka C" : "Skretnica 0 -> ivica ka B");
+        expect(walk(nearSwitch, 50), branch ? "Prelaz na granu 1 bez preloma" : "Prelaz na granu 0 bez preloma");
+
+        // unazad sa grane: uvek na glavni krak, smer ostaje napred
+        moved = advanceOnGraph(graph, pos, -0.1);
+        expect(moved && pos.edge == trunk && pos.dir == 1 && std::fabs(pos.s - nearSwitch.s) < 1e-6,
+            branch ? "Unazad sa grane 1 -> glavni krak" : "Unazad sa grane 0 -> glavni krak");
+        GraphPosition back = pos;
+        back.dir = -1;
+        back.edge = expected;
+        back.s = 0.05;
+        expect(walk(back, 50), "Unazad preko skretnice bez preloma");
+    }
+
+    // branik: ivica ka C nema nastavak na kraju, a glavni krak na pocetku
+    GraphPosition pos;
+    pos.edge = toC;
+    pos.s = 0.05;
+    const bool pastEnd = advanceOnGraph(graph, pos, 10.0);
+    expect(!pastEnd && pos.edge == toC && pos.s == graph.edges[toC].track.totalLength, "Branik na kraju grane");
+    pos = nearSwitch;
+    const bool pastStart = advanceOnGraph(graph, pos, -10.0);
+    expect(!pastStart && pos.edge == trunk && pos.s == 0.0 && pos.dir == 1, "Branik na pocetku glavnog kraka");
+    return failed ? 1 : 0;
+}
+
+// serijski i paralelno napravljena mreza moraju imati bit po bit iste tabele
+static int checkGraphBuild(int numEdges, uint64_t seed, int threads)
+{
+    TrackGraph serial, parallel;
+    makeTestGraph(serial, numEdges, seed);
+    makeTestGraph(parallel, numEdges, seed);
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = buildTrackGraph(serial, 1);
+    double serialWall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    ok = buildTrackGraph(parallel, threads) && ok;
+    double parallelWall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) {
+        std::cout << "Mreza nije napravljena.\n";
+        return 1;
+    }
+
+    int differ = 0;
+    for (size_t i = 0; i < serial.edges.size(); ++i) {
+        const TrackBuffer& a = serial.edges[i].track;
+        const TrackBuffer& b = parallel.edges[i].track;
+        bool same = a.count == b.count && a.arcTableSize == b.arcTableSize && a.totalLength == b.totalLength &&
+                    sameArray(a.x, b.x, a.count) && sameArray(a.y, b.y, a.count) &&
+                    sameArray(a.tx, b.tx, a.count) && sameArray(a.ty, b.ty, a.count) &&
+                    sameArray(a.arcLen, b.arcLen, a.count) && sameArray(a.arcT, b.arcT, a.arcTableSize + 1);
+        if (!same) ++differ;
+    }
+
+    std::printf("Mreza:            %zu ivica, %zu cvorova\n", serial.edges.size(), serial.nodes.size());
+    std::printf("Jedna nit:        %.3f ms\n", serialWall * 1e3);
+    std::printf("Paralelno:        %.3f ms (%d niti)\n", parallelWall * 1e3, stealingThreadCount((int)serial.edges.size(), threads));
+    std::printf("Razlicitih ivica: %d\n", differ);
+    return (checkGraphTraversal() || differ) ? 1 : 0;
+}
+
+// sampleTrackBatch: svi nivoi (SSE2/AVX2 koliko procesor ima) moraju dati isto sto i skalarni,
+// a skalarni isto sto i sampleTrackFrame; t van [0,1] i tacno na tackama staze su ukljuceni
+static int checkSampleBatch(const TrackBuffer& track, int numSamples, uint64_t seed)
+{
+    std::vector<float> t;
+    const float last = (float)(track.count - 1);
+    t.push_back(0.0f);
+    t.push_back(-0.0f);
+    t.push_back(1.0f);
+    t.push_back(std::nextafter(1.0f, 0.0f));
+    t.push_back(std::nextafter(0.0f, 1.0f));
+    t.push_back(-0.25f);
+    t.push_back(1.25f);
+    t.push_back(2.0f);
+    for (int i = 0; i < track.count; i += std::max(1, track.count / 64))
+        t.push_back((float)i / last);                  // tacno na tacki staze (alpha = 0)
+    uint64_t random = seed;
+    while ((int)t.size() < numSamples)
+        t.push_back((float)(randomUnit(random) * 1.5 - 0.25));
+    t.push_back(0.5f);                                 // ukupno nije deljivo sa 8 - i ostatak ide skalarno
+    const int n = (int)t.size();
+
+    struct Out { std::vector<float> x, y, tx, ty; };
+    auto run = [&](SimdLevel level) {
+        Out o{ std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+        sampleTrackBatch(level, track, t.data(), n, o.x.data(), o.y.data(), o.tx.data(), o.ty.data());
+        return o;
+    };
+    auto same = [](const std::vector<float>& a, const std::vector<float>& b) {
+        return std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    };
+
+    const Out scalar = run(SimdLevel::Scalar);
+    int failed = 0;
+
+    int frameDiffer = 0;
+    for (int k = 0; k < n; ++k) {
+        TrackFrame f = sampleTrackFrame(t[k], track);
+        Vec2 p = sampleTrack(t[k], track);
+        if (f.pos.x != scalar.x[k] || f.pos.y != scalar.y[k] || p.x != scalar.x[k] || p.y != scalar.y[k] ||
+            f.tangent.x != scalar.tx[k] || f.tangent.y != scalar.ty[k])
+            ++frameDiffer;
+    }
+    std::printf("Uzoraka:          %d\n", n);
+    std::printf("Scalar/Frame:     %d razlicitih\n", frameDiffer);
+    if (frameDiffer) ++failed;
+
+    const SimdLevel best = detectSimdLevel();
+    const SimdLevel levels[] = { SimdLevel::SSE2, SimdLevel::AVX2 };
+    const char* names[] = { "SSE2", "AVX2" };
+    for (int l = 0; l < 2; ++l) {
+        if ((int)levels[l] > (int)best) {
+            std::printf("%-6s            procesor nema - preskoceno\n", names[l]);
+            continue;
+        }
+        Out o = run(levels[l]);
+        bool ok = same(o.x, scalar.x) && same(o.y, scalar.y) && same(o.tx, scalar.tx) && same(o.ty, scalar.ty);
+        std::printf("%-6s/Scalar:     %s\n", names[l], ok ? "isto" : "RAZLICITO");
+        if (!ok) ++failed;
+    }
+    return failed ? 1 : 0;
+}
+
+// ono sto track_q.vert dekodira mora biti na pola koraka od float staze, a delovi sabijeni
+// posle izmene (uploadQuantTrackRange) isti kao isti delovi cele sabijene staze
+static int checkQuantTrack(const TrackBuffer& track)
+{
+    const int numChunks = (track.count + QUANT_CHUNK_POINTS - 1) / QUANT_CHUNK_POINTS;
+    QuantTrack quant;
+    if (!quantizeTrackChunks(quant, track, 0, numChunks) || quant.count != track.count) {
+        std::printf("Sabijanje nije uspelo\n");
+        return 1;
+    }
+
+    int outside = 0;
+    double maxError = 0.0, maxStep = 0.0;
+    for (int i = 0; i < track.count; ++i) {
+        const QuantChunk& c = quant.chunks[i / QUANT_CHUNK_POINTS];
+        Vec2 p = quantPoint(quant, i);
+        double error = std::max(std::fabs((double)p.x - track.x[i]), std::fabs((double)p.y - track.y[i]));
+        // pola koraka od zaokruzivanja, plus float greska ishodista i mnozenja
+        double limit = 0.5 * c.step + 4.0 * FLT_EPSILON *
+            std::max(std::fabs(c.originX), std::fabs(c.originY)) + 4.0 * FLT_EPSILON * 32767.0 * c.step;
+        if (error > limit) ++outside;
+        maxError = std::max(maxError, error);
+        maxStep = std::max(maxStep, (double)c.step);
+    }
+
+    int partsDiffer = 0;
+    for (int first = 0; first < numChunks; first += 3) {
+        QuantTrack part;
+        const int last = std::min(numChunks, first + 2);
+        const int base = first * QUANT_CHUNK_POINTS;
+        if (!quantizeTrackChunks(part, track, first, last) ||
+            std::memcmp(part.chunks.data(), &quant.chunks[first], part.chunks.size() * sizeof(QuantChunk)) ||
+            std::memcmp(part.dx.data(), &quant.dx[base], part.count * sizeof(int16_t)) ||
+            std::memcmp(part.dy.data(), &quant.dy[base], part.count * sizeof(int16_t)))
+            ++partsDiffer;
+    }
+
+    std::printf("Delova:           %d (%d tacaka)\n", numChunks, track.count);
+    std::printf("Najveca greska:   %g (najveci korak %g)\n", maxError, maxStep);
+    std::printf("Van pola koraka:  %d\n", outside);
+    std::printf("Delovi posebno:   %d razlicitih\n", partsDiffer);
+    return (outside || partsDiffer) ? 1 : 0;
+}
+
+static int usage()
+{
+    std::cout << "RideHeadless [--layout fajl] [--generate tacaka seed] [--script fajl] [--hours h] [--seed s]\n"
+                 "             [--runs n] [--threads t] [--sweep opis --out fajl.csv [--samples n]] [--trains n]\n"
+                 "             [--graph ivica] [--simd-check uzoraka] [--quant-check]\n";
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    const char* layoutPath = nullptr;
+    const char* scriptPath = nullptr;
+    int generatePoints = 0;
+    uint64_t generateSeed = 1;
+    double hours = 12.0;
+    bool hoursSet = false;
+    uint64_t seed = 1;
+    int runs = 0;
+    int threads = 0;
+    const char* sweepPath = nullptr;
+    const char* outPath = "sweep.csv";
+    int samples = 0;
+    int trains = 0;
+    int graphEdges = 0;
+    int simdSamples = 0;
+    bool quantCheck = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--layout") && i + 1 < argc) layoutPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--script") && i + 1 < argc) scriptPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--hours") && i + 1 < argc) { hours = std::atof(argv[++i]); hoursSet = true; }
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--sweep") && i + 1 < argc) sweepPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--samples") && i + 1 < argc) samples = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--trains") && i + 1 < argc) trains = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--graph") && i + 1 < argc) graphEdges = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--simd-check") && i + 1 < argc) simdSamples = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--quant-check")) quantCheck = true;
+        else if (!std::strcmp(argv[i], "--generate") && i + 2 < argc) {
+            generatePoints = std::atoi(argv[++i]);
+            generateSeed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else return usage();
+    }
+
+    // mreza pruga ne zavisi od rasporeda glavne staze
+    if (graphEdges > 0)
+        return checkGraphBuild(graphEdges, seed, threads);
+
+    // raspored: fajl, generisan ili ugradjen
+    std::vector<Vec2> ctrlPoints(TRACK_LAYOUT.begin(), TRACK_LAYOUT.end());
+    if (layoutPath) {
+        std::vector<Vec2> loaded;
+        if (!streamControlPoints(layoutPath, layoutFormatFromPath(layoutPath),
+                [&](Vec2 p) { loaded.push_back(p); }) || loaded.size() < (size_t)MIN_TRACK_CTRL) {
+            std::cout << "Raspored nije ucitan: " << layoutPath << "\n";
+            return 1;
+        }
+        ctrlPoints.swap(loaded);
+    }
+    else if (generatePoints > 0) {
+        LayoutParams params;
+        params.seed = generateSeed;
+        params.numCtrl = generatePoints;
+        if (!generateLayout(ctrlPoints, params))
+            std::cout << "Generisan raspored prelazi granicu zakrivljenosti.\n";
+    }
+
+    TrackSpline spline;
+    TrackBuffer track;
+    TrackProfile profile;
+    if (!buildTrackSpline(spline, ctrlPoints.data(), (int)ctrlPoints.size()) ||
+        !buildTrackAdaptive(track, spline, TRACK_TOLERANCE, TRACK_TANGENTS | TRACK_ARC_LENGTH | TRACK_PARAM | TRACK_CURVATURE, 0)) {
+        std::cout << "Staza nije napravljena.\n";
+        return 1;
+    }
+    buildTrackProfile(profile, track, spline);
+    std::cout << "Staza: " << ctrlPoints.size() << " kontrolnih tacaka, duzina " << track.totalLength << "\n";
+
+    if (simdSamples > 0)
+        return checkSampleBatch(track, simdSamples, seed);
+    if (quantCheck)
+        return checkQuantTrack(track);
+
+    if (sweepPath) {
+        std::vector<SweepAxis> axes;
+        if (!loadSweepAxes(sweepPath, axes)) {
+            std::cout << "Opis pretrage nije ucitan: " << sweepPath << "\n";
+            return 1;
+        }
+        SweepSettings settings;
+        settings.samples = samples;
+        settings.seed = seed;
+        settings.numThreads = threads;
+        if (hoursSet) settings.hours = hours;
+
+        auto wallStart = std::chrono::steady_clock::now();
+        long long count = runSweep(profile, axes, settings, outPath);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        if (count < 0) {
+            std::cout << "Ne moze da se pise u " << outPath << "\n";
+            return 1;
+        }
+        std::printf("Kandidata:        %lld -> %s\n", count, outPath);
+        std::printf("Stvarno vreme:    %.3f s (%.0f kandidata u minuti)\n", wall, wall > 0.0 ? count / wall * 60.0 : 0.0);
+        return 0;
+    }
+
+    if (trains > 0) {
+        TrainWorld world;
+        addTrains(world, trains);
+        std::vector<Operator> ops(trains);
+        RideStats stats;   // zbirno za sve vozove
+        RideParams rideParams;
+        for (int i = 0; i < trains; ++i)
+            ops[i].random = seed + (uint64_t)i * 0x9E3779B97F4A7C15ull;
+
+        const double endTime = hoursSet ? hours * 3600.0 : 60.0;
+        const uint8_t BOARDING = (uint8_t)RideState::BOARDING;
+        double stepWall = 0.0;
+        long long ticks = 0;
+        auto wallStart = std::chrono::steady_clock::now();
+        for (double simTime = 0.0; simTime < endTime; simTime = (double)++ticks * SIM_STEP) {
+            // operater dira samo vozove koji stoje na startu ili kojima bas sad pozli
+            for (int i = 0; i < trains; ++i) {
+                const Operator& op = ops[i];
+                if ((world.state[i] == BOARDING && simTime >= op.nextAction) ||
+                    (op.sickPhase >= 0.0 && world.state[i] != BOARDING && phaseFraction(world.phase[i]) >= op.sickPhase)) {
+                    Ride ride = loadTrain(world, i);
+                    runOperator(ride, ops[i], simTime, stats);
+                    storeTrain(world, i, ride);
+                }
+            }
+
+            auto stepStart = std::chrono::steady_clock::now();
+            stepTrains(world, profile, rideParams, SIM_STEP, threads);
+            stepWall += std::chrono::duration<double>(std::chrono::steady_clock::now() - stepStart).count();
+        }
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+        long long finished = 0;
+        for (int i = 0; i < trains; ++i) finished += world.finishedRides[i];
+        std::printf("Vozova:           %d, %.0f s simulacije (%lld koraka)\n", trains, endTime, ticks);
+        std::printf("Zavrsenih tura:   %lld, putnika %ld, muka %d\n", finished, stats.riders, stats.sickStops);
+        std::printf("Korak vozova:     %.3f ms (%.2f ns po vozu)\n",
+            ticks > 0 ? stepWall / ticks * 1e3 : 0.0, ticks > 0 ? stepWall / ticks / trains * 1e9 : 0.0);
+        std::printf("Stvarno vreme:    %.3f s (sa operaterima)\n", wall);
+        return 0;
+    }
+
+    if (runs > 0) {
+        MonteCarloParams params;
+        params.runs = runs;
+        params.hours = hours;
+        params.seed = seed;
+        params.numThreads = threads;
+
+        auto wallStart = std::chrono::steady_clock::now();
+        MonteCarloResult r = runMonteCarlo(profile, params);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+        std::printf("Simulacija:       %d x %.2f h\n", r.runs, hours);
+        std::printf("Putnika na sat:   %.1f (p5 %.0f, p50 %.0f, p95 %.0f)\n",
+            r.ridersPerHour, r.ridersPerHourP5, r.ridersPerHourP50, r.ridersPerHourP95);
+        std::printf("Ciklus (s):       p50 %.1f, p90 %.1f, p99 %.1f\n", r.cycleP50, r.cycleP90, r.cycleP99);
+        std::printf("Zastoj:           %.2f %% vremena, %.2f muka na sat\n", 100.0 * r.downtimeFraction, r.sickStopsPerHour);
+        std::printf("Stvarno vreme:    %.3f s, %.1f miliona koraka/s\n", wall, wall > 0.0 ? r.steps / wall * 1e-6 : 0.0);
+        return 0;
+    }
+
+    std::vector<ScriptCommand> script;
+    if (scriptPath && !loadScript(scriptPath, script)) {
+        std::cout << "Skripta nije ucitana: " << scriptPath << "\n";
+        return 1;
+    }
+
+    // skripta traje do poslednje komande i jos dok se vagon ne vrati; operater do kraja dana
+    const double endTime = scriptPath ? (script.empty() ? 0.0 : script.back().time) : hours * 3600.0;
+
+    Ride ride;
+    RideParams rideParams;
+    RideStats stats;
+    Operator op;
+    op.random = seed;
+    size_t nextCommand = 0;
+    long long steps = 0;
+    double simTime = 0.0;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    if (!scriptPath) {
+        steps = runOperatedRide(ride, profile, rideParams, op, endTime, stats);
+        simTime = (double)steps * SIM_STEP;
+    }
+    while (scriptPath) {
+        while (nextCommand < script.size() && script[nextCommand].time <= simTime)
+            runCommand(ride, script[nextCommand++], stats);
+        if (simTime >= endTime && ride.state == RideState::BOARDING) break;
+
+        stepRide(ride, profile, rideParams, SIM_STEP);
+        ++steps;
+        simTime = (double)steps * SIM_STEP;   // bez sabiranja - ne odluta za dug dan
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::printf("Simulirano:       %.1f s (%.2f h), %lld koraka\n", simTime, simTime / 3600.0, steps);
+    std::printf("Zavrsene ture:    %d\n", ride.finishedRides);
+    std::printf("Putnika ukrcano:  %ld\n", stats.passengersBoarded);
+    std::printf("Muka (1-8):       %d\n", stats.sickStops);
+    std::printf("Hitna stajanja:   %d\n", stats.hardStops);
+    std::printf("Odbijen start:    %d\n", stats.refusedStarts);
+    std::printf("Stvarno vreme:    %.3f s (%.0fx brze od stvarnog)\n", wall, wall > 0.0 ? simTime / wall : 0.0);
+    return 0;
+}
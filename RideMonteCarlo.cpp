@@ -0,0 +1,59 @@
+#include "RideMonteCarlo.h"
+#include "WorkStealing.h"
+
+#include <algorithm>
+
+
+// p u [0,1]; niz se delimicno preuredjuje
+static double percentile(std::vector<float>& values, double p)
+{
+    if (values.empty()) return 0.0;
+    size_t k = std::min(values.size() - 1, (size_t)(p * (double)(values.size() - 1) + 0.5));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+MonteCarloResult runMonteCarlo(const TrackProfile& profile, const MonteCarloParams& params)
+{
+    MonteCarloResult result;
+    const int runs = std::max(params.runs, 0);
+    const double seconds = params.hours * 3600.0;
+    if (runs == 0 || seconds <= 0.0) return result;
+
+    // svaka simulacija pise samo u svoje mesto - niti ne dele nista sem staze (samo citanje)
+    std::vector<RideStats> stats(runs);
+    std::vector<long long> steps(runs);
+
+    parallelForStealing(runs, params.numThreads, [&](int run, int) {
+        uint64_t stream = params.seed + (uint64_t)run * 0xD1B54A32D192ED03ull;
+        Ride ride;
+        Operator op;
+        op.random = nextRandom(stream);
+        op.params = params.op;
+        steps[run] = runOperatedRide(ride, profile, params.ride, op, seconds, stats[run]);
+    });
+
+    std::vector<float> ridersPerHour(runs);
+    std::vector<float> cycles;
+    double downtime = 0.0, sickStops = 0.0;
+    for (int r = 0; r < runs; ++r) {
+        ridersPerHour[r] = (float)(stats[r].riders / params.hours);
+        cycles.insert(cycles.end(), stats[r].cycleTimes.begin(), stats[r].cycleTimes.end());
+        downtime += stats[r].downtime;
+        sickStops += stats[r].sickStops;
+        result.ridersPerHour += ridersPerHour[r];
+        result.steps += steps[r];
+    }
+
+    result.runs = runs;
+    result.ridersPerHour /= runs;
+    result.ridersPerHourP5 = percentile(ridersPerHour, 0.05);
+    result.ridersPerHourP50 = percentile(ridersPerHour, 0.50);
+    result.ridersPerHourP95 = percentile(ridersPerHour, 0.95);
+    result.cycleP50 = percentile(cycles, 0.50);
+    result.cycleP90 = percentile(cycles, 0.90);
+    result.cycleP99 = percentile(cycles, 0.99);
+    result.downtimeFraction = downtime / (seconds * runs);
+    result.sickStopsPerHour = sickStops / (params.hours * runs);
+    return result;
+}
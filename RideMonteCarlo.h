@@ -0,0 +1,28 @@
+#pragma once
+#include "RideOperator.h"
+
+// ================== Procena kapaciteta (Monte Carlo) ==================
+// Hiljade nezavisnih radnih perioda iste staze, svaki sa svojim slucajnim operaterom (ukrcavanje,
+// pojasevi, muka). Niz slucajnih brojeva zavisi samo od seed-a i rednog broja simulacije,
+// pa je rezultat isti bez obzira na broj niti.
+
+struct MonteCarloParams {
+    int            runs = 1000;
+    double         hours = 1.0;      // trajanje jedne simulacije
+    uint64_t       seed = 1;
+    int            numThreads = 0;   // 0 = sva jezgra
+    OperatorParams op;
+    RideParams     ride;
+};
+
+struct MonteCarloResult {
+    int    runs = 0;
+    double ridersPerHour = 0.0;                          // prosek
+    double ridersPerHourP5 = 0.0, ridersPerHourP50 = 0.0, ridersPerHourP95 = 0.0;
+    double cycleP50 = 0.0, cycleP90 = 0.0, cycleP99 = 0.0;   // s izmedju dva starta
+    double downtimeFraction = 0.0;                       // deo vremena u zastoju (prosek)
+    double sickStopsPerHour = 0.0;
+    long long steps = 0;                                 // ukupno koraka simulacije
+};
+
+MonteCarloResult runMonteCarlo(const TrackProfile& profile, const MonteCarloParams& params);
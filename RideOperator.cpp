@@ -0,0 +1,89 @@
+#include "RideOperator.h"
+
+
+static double randomBetween(uint64_t& state, double lo, double hi)
+{
+    return lo + (hi - lo) * randomUnit(state);
+}
+
+void runOperator(Ride& ride, Operator& op, double simTime, RideStats& stats)
+{
+    // tura je jedan krug od starta, pa se mesto bira po delu kruga - pozli uvek dok tura traje
+    if (op.sickPhase >= 0.0 &&
+        (ride.state == RideState::ACCELERATING || ride.state == RideState::RUNNING) &&
+        phaseFraction(ride.phase) >= op.sickPhase) {
+        int seat = (int)(randomUnit(op.random) * ride.passengerCount);
+        for (int i = 0; i < MAX_SEATS; ++i) {
+            if (ride.passengers[i].present && seat-- == 0) {
+                if (makeSick(ride, i)) ++stats.sickStops;
+                break;
+            }
+        }
+        op.sickPhase = -1.0;
+    }
+
+    if (ride.state != RideState::BOARDING || simTime < op.nextAction) return;
+
+    if (ride.clearingPassengers) {
+        for (int i = 0; i < MAX_SEATS; ++i) {
+            if (ride.passengers[i].present) {
+                clickSeat(ride, i);
+                break;
+            }
+        }
+        op.nextAction = simTime + randomBetween(op.random, op.params.unloadMin, op.params.unloadMax);
+        return;
+    }
+
+    if (op.groupSize == 0)
+        op.groupSize = 1 + (int)(randomUnit(op.random) * MAX_SEATS);
+
+    if (ride.passengerCount < op.groupSize) {
+        if (addPassenger(ride)) ++stats.passengersBoarded;
+        op.nextAction = simTime + randomBetween(op.random, op.params.boardMin, op.params.boardMax);
+        return;
+    }
+
+    if (!op.belting) {
+        op.belting = true;
+        op.nextAction = simTime + randomBetween(op.random, op.params.beltMin, op.params.beltMax);
+        return;
+    }
+
+    toggleAllBelts(ride);   // niko jos nije vezan -> vezi sve
+    op.belting = false;
+    if (!pressStart(ride)) {
+        ++stats.refusedStarts;
+        return;
+    }
+
+    ++stats.dispatches;
+    stats.riders += ride.passengerCount;
+    if (stats.lastDispatch >= 0.0)
+        stats.cycleTimes.push_back((float)(simTime - stats.lastDispatch));
+    stats.lastDispatch = simTime;
+
+    op.groupSize = 0;
+    op.sickPhase = -1.0;
+    if (randomUnit(op.random) < op.params.sickChance)
+        op.sickPhase = randomUnit(op.random);
+}
+
+long long runOperatedRide(Ride& ride, const TrackProfile& profile, const RideParams& params, Operator& op,
+    double seconds, RideStats& stats)
+{
+    long long steps = 0;
+    double simTime = 0.0;
+    while (simTime < seconds) {
+        runOperator(ride, op, simTime, stats);
+        stepRide(ride, profile, params, SIM_STEP);
+
+        if (ride.state == RideState::STOPPING_SICK || ride.state == RideState::PAUSED_SICK ||
+            ride.state == RideState::RETURNING)
+            stats.downtime += SIM_STEP;
+
+        ++steps;
+        simTime = (double)steps * SIM_STEP;   // bez sabiranja - ne odluta za dug dan
+    }
+    return steps;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Random.h"
+#include "Ride.h"
+
+#include <cstdint>
+#include <vector>
+
+// ================== Operater voznje (bez prozora) ==================
+// Umesto coveka za tastaturom: ukrca 1-8 putnika, posle nekog vremena veze pojaseve, pusti
+// vagon i iskrca putnike kad se vrati. Vremena i muka (tasteri 1-8) su slucajni iz sopstvenog
+// generatora, pa isti seed daje isti dan na svakom racunaru i u svakoj niti.
+
+struct OperatorParams {
+    double boardMin = 1.0, boardMax = 3.0;     // razmak izmedju dva putnika koji sedaju (s)
+    double beltMin = 2.0, beltMax = 8.0;       // od poslednjeg putnika do vezanih pojaseva i starta (s)
+    double unloadMin = 0.5, unloadMax = 1.5;   // razmak izmedju dva putnika koji izlaze (s)
+    double sickChance = 0.05;                  // deo tura u kojima nekome pozli (na slucajnom mestu ture)
+};
+
+struct RideStats {
+    long   passengersBoarded = 0;
+    long   riders = 0;              // putnici u pustenim turama
+    int    dispatches = 0;          // uspesni startovi
+    int    sickStops = 0;
+    int    hardStops = 0;
+    int    refusedStarts = 0;
+    double downtime = 0.0;          // s u kocenju, pauzi i povratku posle muke ili hitnog stajanja
+    double lastDispatch = -1.0;
+    std::vector<float> cycleTimes;  // s izmedju dva uzastopna starta
+};
+
+struct Operator {
+    uint64_t       random = 1;
+    OperatorParams params;
+    double         nextAction = 0.0;
+    int            groupSize = 0;      // koliko putnika ide u ovu turu
+    bool           belting = false;    // grupa je na mestu, ceka se pojas
+    double         sickPhase = -1.0;   // deo kruga na kome ce nekome pozleti (-1 = nikom u ovoj turi)
+};
+
+
+// Jedan potez operatera u trenutku simTime (zove se pre svakog stepRide)
+void runOperator(Ride& ride, Operator& op, double simTime, RideStats& stats);
+
+// Operater i simulacija zajedno, "seconds" sekundi od pocetka (korak SIM_STEP). Vraca broj koraka.
+long long runOperatedRide(Ride& ride, const TrackProfile& profile, const RideParams& params, Operator& op,
+    double seconds, RideStats& stats);
@@ -0,0 +1,188 @@
+#include "RideSweep.h"
+#include "WorkStealing.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+struct RideField {
+    const char* name;
+    float RideParams::* member;
+};
+
+static const RideField RIDE_FIELDS[] = {
+    { "startAccel",    &RideParams::startAccel },
+    { "targetSpeed",   &RideParams::targetSpeed },
+    { "gravityAccel",  &RideParams::gravityAccel },
+    { "minSpeed",      &RideParams::minSpeed },
+    { "maxSpeed",      &RideParams::maxSpeed },
+    { "brakeAccel",    &RideParams::brakeAccel },
+    { "returnSpeed",   &RideParams::returnSpeed },
+    { "downhillAccel", &RideParams::downhillAccel },
+    { "uphillBrake",   &RideParams::uphillBrake },
+    { "friction",      &RideParams::friction },
+};
+static const int NUM_RIDE_FIELDS = (int)(sizeof(RIDE_FIELDS) / sizeof(RIDE_FIELDS[0]));
+
+static const double SWEEP_RIDE_LIMIT = 600.0;   // s; tura koja se ne vrati do tada je "zaglavljena"
+
+
+bool loadSweepAxes(const char* path, std::vector<SweepAxis>& axes)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+
+        std::istringstream ls(line);
+        SweepAxis a;
+        if (!(ls >> a.name)) continue;   // prazna linija
+        if (!(ls >> a.lo >> a.hi)) {
+            std::cout << path << ":" << lineNo << ": ocekuje se \"ime donja gornja [koraka]\"\n";
+            return false;
+        }
+        if (!(ls >> a.steps)) a.steps = 5;
+        for (int f = 0; f < NUM_RIDE_FIELDS; ++f)
+            if (a.name == RIDE_FIELDS[f].name) a.field = f;
+        if (a.field < 0) {
+            std::cout << path << ":" << lineNo << ": nepoznat parametar " << a.name << "\n";
+            return false;
+        }
+        if (a.steps < 1) {
+            std::cout << path << ":" << lineNo << ": broj koraka mora biti bar 1\n";
+            return false;
+        }
+        axes.push_back(a);
+    }
+    return true;
+}
+
+SweepMetrics evaluateRideParams(const TrackProfile& profile, const RideParams& params, const SweepSettings& settings)
+{
+    SweepMetrics m;
+
+    // jedna puna tura
+    Ride ride;
+    for (int i = 0; i < MAX_SEATS; ++i)
+        addPassenger(ride);
+    toggleAllBelts(ride);
+    pressStart(ride);
+
+    bool ran = false;
+    float minSpeed = params.maxSpeed, maxSpeed = 0.0f;
+    long long steps = 0, stepsAtMin = 0, stepsAtMax = 0;
+    while (ride.state != RideState::BOARDING && steps * SIM_STEP < SWEEP_RIDE_LIMIT) {
+        stepRide(ride, profile, params, SIM_STEP);
+        ++steps;
+        if (ride.state != RideState::RUNNING) continue;
+
+        ran = true;
+        minSpeed = std::min(minSpeed, ride.speed);
+        maxSpeed = std::max(maxSpeed, ride.speed);
+        if (ride.speed <= params.minSpeed) ++stepsAtMin;
+        if (ride.speed >= params.maxSpeed) ++stepsAtMax;
+    }
+    m.finished = (ride.state == RideState::BOARDING);
+    m.rideTime = (float)(steps * SIM_STEP);
+    m.minSpeed = ran ? minSpeed : 0.0f;
+    m.maxSpeed = maxSpeed;
+    m.timeAtMin = (float)(stepsAtMin * SIM_STEP);
+    m.timeAtMax = (float)(stepsAtMax * SIM_STEP);
+
+    // kapacitet sa operaterom - isti niz slucajnih brojeva za svakog kandidata
+    if (settings.hours > 0.0) {
+        Ride day;
+        Operator op;
+        RideStats stats;
+        op.random = settings.seed;
+        runOperatedRide(day, profile, params, op, settings.hours * 3600.0, stats);
+        m.ridersPerHour = (float)(stats.riders / settings.hours);
+    }
+    return m;
+}
+
+// Fisher-Yates, sopstveni generator
+static void shuffle(std::vector<int>& v, uint64_t& state)
+{
+    for (int i = (int)v.size() - 1; i > 0; --i)
+        std::swap(v[i], v[(int)(nextRandom(state) % (uint64_t)(i + 1))]);
+}
+
+long long runSweep(const TrackProfile& profile, const std::vector<SweepAxis>& axes,
+    const SweepSettings& settings, const char* outPath)
+{
+    FILE* out = std::fopen(outPath, "w");
+    if (!out) return -1;
+
+    const int numAxes = (int)axes.size();
+    const bool lhs = settings.samples > 0;
+
+    long long total = 1;
+    if (lhs) total = settings.samples;
+    else for (const SweepAxis& a : axes) total *= a.steps;
+
+    // LHS: svaka osa podeljena na "samples" slojeva, svaki sloj tacno jednom
+    std::vector<std::vector<int>> strata(lhs ? numAxes : 0);
+    uint64_t state = settings.seed;
+    for (std::vector<int>& s : strata) {
+        s.resize(settings.samples);
+        for (int i = 0; i < settings.samples; ++i) s[i] = i;
+        shuffle(s, state);
+    }
+
+    auto candidate = [&](long long index) {
+        RideParams p;
+        uint64_t jitter = settings.seed ^ ((uint64_t)index * 0xD1B54A32D192ED03ull);
+        long long rest = index;
+        for (int a = 0; a < numAxes; ++a) {
+            const SweepAxis& axis = axes[a];
+            double u;
+            if (lhs) {
+                u = (strata[a][index] + randomUnit(jitter)) / settings.samples;
+            }
+            else {
+                int step = (int)(rest % axis.steps);
+                rest /= axis.steps;
+                u = (axis.steps > 1) ? (double)step / (axis.steps - 1) : 0.0;
+            }
+            p.*RIDE_FIELDS[axis.field].member = (float)(axis.lo + (axis.hi - axis.lo) * u);
+        }
+        return p;
+    };
+
+    std::fprintf(out, "index");
+    for (const SweepAxis& a : axes) std::fprintf(out, ",%s", a.name.c_str());
+    std::fprintf(out, ",finished,rideTime,rideMinSpeed,rideMaxSpeed,timeAtMin,timeAtMax,ridersPerHour\n");
+
+    const int batch = std::max(settings.batch, 1);
+    std::vector<RideParams> params(batch);
+    std::vector<SweepMetrics> metrics(batch);
+    for (long long first = 0; first < total; first += batch) {
+        const int n = (int)std::min<long long>(batch, total - first);
+        for (int i = 0; i < n; ++i)
+            params[i] = candidate(first + i);
+
+        parallelForStealing(n, settings.numThreads, [&](int i, int) {
+            metrics[i] = evaluateRideParams(profile, params[i], settings);
+        });
+
+        for (int i = 0; i < n; ++i) {
+            const SweepMetrics& m = metrics[i];
+            std::fprintf(out, "%lld", first + i);
+            for (const SweepAxis& a : axes)
+                std::fprintf(out, ",%.6g", params[i].*RIDE_FIELDS[a.field].member);
+            std::fprintf(out, ",%d,%.3f,%.4f,%.4f,%.3f,%.3f,%.1f\n", m.finished ? 1 : 0, m.rideTime,
+                m.minSpeed, m.maxSpeed, m.timeAtMin, m.timeAtMax, m.ridersPerHour);
+        }
+        std::fflush(out);
+    }
+    std::fclose(out);
+    return total;
+}
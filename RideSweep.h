@@ -0,0 +1,51 @@
+#pragma once
+#include "RideOperator.h"
+
+#include <string>
+#include <vector>
+
+// ================== Pretraga parametara voznje ==================
+// Mreza ili latinska hiperkocka (LHS) preko polja RideParams. Svaki kandidat se vozi bez prozora:
+// jedna puna tura sa 8 putnika (vreme, najmanja / najveca brzina, koliko stoji na granicama)
+// i kratak period sa operaterom (putnika na sat). Kandidati idu paralelno u grupama, a svaka
+// grupa se odmah dopisuje u CSV redom kojim su kandidati zadati.
+//
+// Opis pretrage (tekst, # je komentar):   ime donja gornja [koraka]
+//   targetSpeed 0.8 1.6 5
+//   downhillAccel 10 20 3
+// Imena su polja RideParams; ostala polja ostaju podrazumevana. Koraci vaze samo za mrezu.
+
+struct SweepAxis {
+    std::string name;
+    int   field = -1;     // indeks u tabeli polja RideParams
+    float lo = 0.0f, hi = 0.0f;
+    int   steps = 5;
+};
+
+struct SweepSettings {
+    int      samples = 0;         // > 0: LHS sa toliko kandidata; 0: puna mreza
+    uint64_t seed = 1;            // LHS i operater (isti za sve kandidate - poredjenje je posteno)
+    double   hours = 0.25;        // period sa operaterom po kandidatu; 0 = bez
+    int      numThreads = 0;      // 0 = sva jezgra
+    int      batch = 1024;        // kandidata po grupi (toliko rezultata ceka na upis)
+};
+
+struct SweepMetrics {
+    bool  finished = false;       // tura se vratila na start pre isteka vremena
+    float rideTime = 0.0f;        // s od starta do povratka
+    float minSpeed = 0.0f;        // u RUNNING
+    float maxSpeed = 0.0f;
+    float timeAtMin = 0.0f;       // s na minSpeed granici (vagon "puzi")
+    float timeAtMax = 0.0f;       // s na maxSpeed granici
+    float ridersPerHour = 0.0f;
+};
+
+// Cita opis pretrage; na gresku ispisuje "fajl:linija: opis" i vraca false
+bool loadSweepAxes(const char* path, std::vector<SweepAxis>& axes);
+
+// Jedan kandidat
+SweepMetrics evaluateRideParams(const TrackProfile& profile, const RideParams& params, const SweepSettings& settings);
+
+// Cela pretraga u CSV "outPath". Vraca broj kandidata, -1 ako fajl ne moze da se otvori.
+long long runSweep(const TrackProfile& profile, const std::vector<SweepAxis>& axes,
+    const SweepSettings& settings, const char* outPath);
@@ -0,0 +1,224 @@
+#include "TrackCheck.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const int MAX_GRID_SIDE = 4096;
+static const int RUN_SEGMENTS = 64;      // najvise duzi u jednom nizu
+
+
+static float cross(float ax, float ay, float bx, float by)
+{
+    return ax * by - ay * bx;
+}
+
+// najbliza tacka duzi ab tacki p
+static Vec2 closestOnSegment(Vec2 p, Vec2 a, Vec2 b)
+{
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float len2 = dx * dx + dy * dy;
+    float alpha = (len2 > 0.0f) ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0f;
+    alpha = std::min(std::max(alpha, 0.0f), 1.0f);
+    return { a.x + dx * alpha, a.y + dy * alpha };
+}
+
+static float dist2(Vec2 a, Vec2 b)
+{
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+// rastojanje dve duzi; "onA" = najbliza tacka na prvoj; 0 ako se seku
+static float segmentDistance(Vec2 a0, Vec2 a1, Vec2 b0, Vec2 b1, Vec2& onA, bool& crosses)
+{
+    // pravi presek: krajevi svake duzi su sa razlicitih strana druge
+    float d1 = cross(b1.x - b0.x, b1.y - b0.y, a0.x - b0.x, a0.y - b0.y);
+    float d2 = cross(b1.x - b0.x, b1.y - b0.y, a1.x - b0.x, a1.y - b0.y);
+    float d3 = cross(a1.x - a0.x, a1.y - a0.y, b0.x - a0.x, b0.y - a0.y);
+    float d4 = cross(a1.x - a0.x, a1.y - a0.y, b1.x - a0.x, b1.y - a0.y);
+    crosses = ((d1 > 0.0f) != (d2 > 0.0f)) && ((d3 > 0.0f) != (d4 > 0.0f)) &&
+              d1 != 0.0f && d2 != 0.0f && d3 != 0.0f && d4 != 0.0f;
+    if (crosses) {
+        float alpha = d1 / (d1 - d2);
+        onA = { a0.x + (a1.x - a0.x) * alpha, a0.y + (a1.y - a0.y) * alpha };
+        return 0.0f;
+    }
+
+    // inace je najblize neko teme jedne duzi drugoj duzi
+    float best = dist2(a0, closestOnSegment(a0, b0, b1));
+    onA = a0;
+    float d = dist2(a1, closestOnSegment(a1, b0, b1));
+    if (d < best) { best = d; onA = a1; }
+    Vec2 q = closestOnSegment(b0, a0, a1);
+    d = dist2(b0, q);
+    if (d < best) { best = d; onA = q; }
+    q = closestOnSegment(b1, a0, a1);
+    d = dist2(b1, q);
+    if (d < best) { best = d; onA = q; }
+    return std::sqrt(best);
+}
+
+int checkTrack(const TrackBuffer& track, float clearance, float minGap, std::vector<TrackIssue>& issues)
+{
+    issues.clear();
+    if (track.count < 3 || clearance <= 0.0f) return 0;
+
+    const int numSegments = track.count - 1;
+
+    // duzina od pocetka do svake tacke (iz staze ako je ima)
+    std::vector<float> arcLocal;
+    const float* arc = track.arcLen;
+    if (!arc) {
+        arcLocal.resize(track.count);
+        arcLocal[0] = 0.0f;
+        for (int i = 1; i < track.count; ++i)
+            arcLocal[i] = arcLocal[i - 1] + std::sqrt(dist2({ track.x[i], track.y[i] }, { track.x[i - 1], track.y[i - 1] }));
+        arc = arcLocal.data();
+    }
+    const float total = arc[numSegments];
+    const float minAlongTrack = std::max(minGap, 0.5f * 3.14159265f * clearance);   // bar pola kruga precnika clearance
+
+    // nizovi uzastopnih duzi (najvise clearance/2 dugi) - mreza i parovi idu po nizovima,
+    // pa gusto podeljena staza ne pravi kvadratni broj parova u jednoj celiji
+    struct Run {
+        int first, last;                    // duzi [first, last)
+        float minX, minY, maxX, maxY;       // okvir prosiren za clearance
+    };
+    std::vector<Run> runs;
+    for (int i = 0; i < numSegments; ) {
+        Run run;
+        run.first = i;
+        run.minX = run.maxX = track.x[i];
+        run.minY = run.maxY = track.y[i];
+        do {
+            run.minX = std::min(run.minX, track.x[i + 1]); run.maxX = std::max(run.maxX, track.x[i + 1]);
+            run.minY = std::min(run.minY, track.y[i + 1]); run.maxY = std::max(run.maxY, track.y[i + 1]);
+            ++i;
+        } while (i < numSegments && i - run.first < RUN_SEGMENTS && arc[i + 1] - arc[run.first] <= 0.5f * clearance);
+        run.last = i;
+        run.minX -= clearance; run.minY -= clearance;
+        run.maxX += clearance; run.maxY += clearance;
+        runs.push_back(run);
+    }
+    const int numRuns = (int)runs.size();
+
+    // mreza: celija >= clearance
+    float minX = runs[0].minX, maxX = runs[0].maxX, minY = runs[0].minY, maxY = runs[0].maxY;
+    for (const Run& run : runs) {
+        minX = std::min(minX, run.minX); maxX = std::max(maxX, run.maxX);
+        minY = std::min(minY, run.minY); maxY = std::max(maxY, run.maxY);
+    }
+    float cell = std::max(clearance, std::max(maxX - minX, maxY - minY) / (float)MAX_GRID_SIDE);
+    int cols = std::min((int)((maxX - minX) / cell) + 1, MAX_GRID_SIDE);
+    int rows = std::min((int)((maxY - minY) / cell) + 1, MAX_GRID_SIDE);
+
+    auto cellRange = [&](const Run& run, int& c0, int& c1, int& r0, int& r1) {
+        c0 = std::max(0, (int)((run.minX - minX) / cell));  c1 = std::min(cols - 1, (int)((run.maxX - minX) / cell));
+        r0 = std::max(0, (int)((run.minY - minY) / cell));  r1 = std::min(rows - 1, (int)((run.maxY - minY) / cell));
+    };
+
+    // dva prolaza kao u TrackIndex: prebrojavanje, pa upis
+    std::vector<int> cellStart((size_t)cols * rows + 1, 0);
+    for (const Run& run : runs) {
+        int c0, c1, r0, r1;
+        cellRange(run, c0, c1, r0, r1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                ++cellStart[(size_t)r * cols + c + 1];
+    }
+    for (size_t c = 0; c + 1 < cellStart.size(); ++c)
+        cellStart[c + 1] += cellStart[c];
+    std::vector<int> cellRuns(cellStart.back());
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int k = 0; k < numRuns; ++k) {
+        int c0, c1, r0, r1;
+        cellRange(runs[k], c0, c1, r0, r1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                cellRuns[fill[(size_t)r * cols + c]++] = k;
+    }
+
+    // razmak duz staze izmedju duzi a < b (krace od dva smera po zatvorenoj stazi)
+    auto alongTrack = [&](int a, int b) {
+        return std::min(arc[b] - arc[a + 1], total - (arc[b + 1] - arc[a]));
+    };
+
+    // svaki par nizova u istoj celiji; par se proverava samo u prvoj zajednickoj celiji (bez duplikata)
+    std::vector<TrackIssue> hits;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const int cellIndex = r * cols + c;
+            for (int p = cellStart[cellIndex]; p < cellStart[cellIndex + 1]; ++p) {
+                for (int q = p + 1; q < cellStart[cellIndex + 1]; ++q) {
+                    const Run& A = runs[std::min(cellRuns[p], cellRuns[q])];
+                    const Run& B = runs[std::max(cellRuns[p], cellRuns[q])];
+
+                    // okviri (prosireni za clearance) su dalji od clearance - nista nije dovoljno blizu
+                    if (A.maxX < B.minX + clearance || B.maxX < A.minX + clearance ||
+                        A.maxY < B.minY + clearance || B.maxY < A.minY + clearance) continue;
+
+                    // ceo par nizova je jedna krivina: najveci razmak unapred ili preko zatvaranja je premali
+                    float maxForward = arc[B.last - 1] - arc[A.first + 1];
+                    float maxWrap = total - (arc[B.first + 1] - arc[A.last - 1]);
+                    if (std::min(maxForward, maxWrap) < minAlongTrack) continue;
+
+                    int ac0, ac1, ar0, ar1, bc0, bc1, br0, br1;
+                    cellRange(A, ac0, ac1, ar0, ar1);
+                    cellRange(B, bc0, bc1, br0, br1);
+                    if (std::max(ac0, bc0) != c || std::max(ar0, br0) != r) continue;
+
+                    for (int a = A.first; a < A.last; ++a) {
+                        for (int b = B.first; b < B.last; ++b) {
+                            // duzi bliske i duz staze su ista krivina
+                            if (alongTrack(a, b) < minAlongTrack) continue;
+
+                            Vec2 onA;
+                            bool crosses;
+                            float d = segmentDistance({ track.x[a], track.y[a] }, { track.x[a + 1], track.y[a + 1] },
+                                { track.x[b], track.y[b] }, { track.x[b + 1], track.y[b + 1] }, onA, crosses);
+                            if (!crosses && d >= clearance) continue;
+
+                            TrackIssue issue;
+                            issue.kind = crosses ? TrackIssueKind::Intersection : TrackIssueKind::Clearance;
+                            issue.segmentA = a;
+                            issue.segmentB = b;
+                            issue.distance = d;
+                            issue.point = onA;
+                            hits.push_back(issue);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // spajanje: jedno mesto daje mnogo parova duzi; parovi cije su obe strane unutar clearance
+    // (duz staze) od vec skupljenih su isto mesto, a zapisuje se najblizi par
+    std::sort(hits.begin(), hits.end(), [](const TrackIssue& x, const TrackIssue& y) {
+        return x.segmentA != y.segmentA ? x.segmentA < y.segmentA : x.segmentB < y.segmentB;
+    });
+
+    std::vector<char> merged(hits.size(), 0);
+    for (size_t h = 0; h < hits.size(); ++h) {
+        if (merged[h]) continue;
+        TrackIssue best = hits[h];
+        float maxA = arc[hits[h].segmentA];
+        float minB = arc[hits[h].segmentB], maxB = minB;
+
+        for (size_t k = h + 1; k < hits.size() && arc[hits[k].segmentA] <= maxA + clearance; ++k) {
+            float sB = arc[hits[k].segmentB];
+            if (merged[k] || sB < minB - clearance || sB > maxB + clearance) continue;
+            merged[k] = 1;
+            maxA = std::max(maxA, arc[hits[k].segmentA]);
+            minB = std::min(minB, sB);
+            maxB = std::max(maxB, sB);
+
+            // presek je vazniji od bliskog prolaza na istom mestu
+            bool better = (hits[k].kind == TrackIssueKind::Intersection) != (best.kind == TrackIssueKind::Intersection)
+                ? hits[k].kind == TrackIssueKind::Intersection
+                : hits[k].distance < best.distance;
+            if (better) best = hits[k];
+        }
+        issues.push_back(best);
+    }
+    return (int)issues.size();
+}
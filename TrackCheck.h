@@ -0,0 +1,28 @@
+#pragma once
+#include "Helpers.h"
+
+#include <vector>
+
+// ================== Provera rasporeda staze ==================
+// Trazi mesta gde se staza sece sama sa sobom i mesta gde dva dela staze (daleka duz staze)
+// prolaze blize od "clearance". Uzastopne duzi se grupisu u kratke nizove, nizovi u ravnomernu
+// mrezu sa celijom >= clearance, pa se porede samo nizovi iz iste celije - za realne staze O(n).
+
+enum class TrackIssueKind {
+    Intersection,   // staza se sece
+    Clearance       // dva dela staze su preblizu
+};
+
+struct TrackIssue {
+    TrackIssueKind kind;
+    int   segmentA, segmentB;   // najblizi par duzi (i, i+1) i (j, j+1), segmentA < segmentB
+    float distance;             // najmanje rastojanje (0 za presek)
+    Vec2  point;                // gde (na duzi segmentA)
+};
+
+// Duzi koje su i duz staze blizu (manje od minGap, a bar pola kruga precnika clearance) se ne porede -
+// to je ista krivina: okret tesnji od toga je problem zakrivljenosti, ne rasporeda. Za vagon minGap
+// treba da bude nekoliko duzina vagona - inace krak tesnog okreta "udari" u drugi krak istog okreta.
+// Svi parovi duzi jednog mesta se spajaju u jedan zapis.
+// Vraca broj nadjenih problema.
+int checkTrack(const TrackBuffer& track, float clearance, float minGap, std::vector<TrackIssue>& issues);
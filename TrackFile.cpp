@@ -0,0 +1,287 @@
+#include "TrackFile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const size_t TRACK_FILE_ALIGN = 32;   // kao TrackBuffer, da SIMD petlje mogu direktno da citaju
+
+
+static uint64_t alignUp(uint64_t v)
+{
+    return (v + TRACK_FILE_ALIGN - 1) & ~(uint64_t)(TRACK_FILE_ALIGN - 1);
+}
+
+TrackFile::~TrackFile()
+{
+    closeTrackFile(*this);
+}
+
+bool operator==(const TrackBuildKey& a, const TrackBuildKey& b)
+{
+    return a.mode == b.mode && a.source == b.source && a.tolerance == b.tolerance &&
+           a.segments == b.segments && a.sourceHash == b.sourceHash;
+}
+
+
+// ================== Kljuc ==================
+uint64_t hashTrackSource(const void* data, size_t bytes, uint64_t hash)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool hashTrackSourceFile(const char* path, uint64_t& hash)
+{
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+
+    char buffer[1 << 16];
+    hash = TRACK_HASH_INIT;
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0)
+        hash = hashTrackSource(buffer, n, hash);
+    bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+
+// ================== Upis ==================
+bool writeTrackFile(const char* path, const TrackBuffer& track, const Vec2* ctrlPoints, int numCtrl,
+    const TrackBuildKey& key)
+{
+    if (track.count < 2 || numCtrl < 1) return false;
+
+    TrackFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "TRAK", 4);
+    header.version = TRACK_FILE_VERSION;
+    header.endian = TRACK_FILE_ENDIAN;
+    header.headerSize = sizeof(TrackFileHeader);
+    header.numCtrl = numCtrl;
+    header.count = track.count;
+    header.arcTableSize = track.hasArcLength() ? track.arcTableSize : 0;
+    header.totalLength = track.totalLength;
+    header.tolerance = track.tolerance;
+    header.key = key;
+
+    // raspored: svaki niz pocinje na 32 bajta
+    struct Chunk { uint64_t* offset; const void* src; size_t bytes; };
+    const size_t arrayBytes = (size_t)track.count * sizeof(float);
+    std::vector<Chunk> chunks;
+    chunks.push_back({ &header.ctrlOffset, ctrlPoints, (size_t)numCtrl * sizeof(Vec2) });
+    chunks.push_back({ &header.xOffset, track.x, arrayBytes });
+    chunks.push_back({ &header.yOffset, track.y, arrayBytes });
+    if (track.hasTangents()) {
+        header.flags |= TRACK_TANGENTS;
+        chunks.push_back({ &header.txOffset, track.tx, arrayBytes });
+        chunks.push_back({ &header.tyOffset, track.ty, arrayBytes });
+    }
+    if (track.hasArcLength()) {
+        header.flags |= TRACK_ARC_LENGTH;
+        chunks.push_back({ &header.arcLenOffset, track.arcLen, arrayBytes });
+        chunks.push_back({ &header.arcTOffset, track.arcT, (size_t)(track.arcTableSize + 1) * sizeof(float) });
+    }
+    if (track.hasParam()) {
+        header.flags |= TRACK_PARAM;
+        chunks.push_back({ &header.spanOffset, track.span, arrayBytes });
+        chunks.push_back({ &header.spanTOffset, track.spanT, arrayBytes });
+    }
+    if (track.hasCurvature()) {
+        header.flags |= TRACK_CURVATURE;
+        chunks.push_back({ &header.curvatureOffset, track.curvature, arrayBytes });
+    }
+
+    uint64_t offset = alignUp(sizeof(TrackFileHeader));
+    for (const Chunk& c : chunks) {
+        *c.offset = offset;
+        offset = alignUp(offset + c.bytes);
+    }
+    header.fileSize = offset;
+
+    FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::cout << "Ne mogu da upisem stazu u " << path << "\n";
+        return false;
+    }
+
+    static const char zeros[TRACK_FILE_ALIGN] = {};
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    uint64_t written = sizeof(header);
+    for (const Chunk& c : chunks) {
+        if (!ok) break;
+        ok = std::fwrite(zeros, 1, (size_t)(*c.offset - written), f) == *c.offset - written &&
+             std::fwrite(c.src, 1, c.bytes, f) == c.bytes;
+        written = *c.offset + c.bytes;
+    }
+    if (ok) ok = std::fwrite(zeros, 1, (size_t)(header.fileSize - written), f) == header.fileSize - written;
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok) {
+        std::cout << "Greska pri upisu staze u " << path << "\n";
+        std::remove(path);
+    }
+    return ok;
+}
+
+
+// ================== Mapiranje ==================
+static bool mapFile(TrackFile& file, const char* path)
+{
+#if defined(_WIN32)
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fh, &size) || size.QuadPart == 0) {
+        CloseHandle(fh);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(fh);
+        return false;
+    }
+
+    file.fileHandle = fh;
+    file.mappingHandle = mapping;
+    file.data = view;
+    file.size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // MAP_SHARED + samo citanje: svi procesi dele iste stranice iz kesa fajl sistema
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);   // mapiranje ostaje i bez otvorenog fajla
+    if (view == MAP_FAILED) return false;
+
+    file.data = view;
+    file.size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void closeTrackFile(TrackFile& file)
+{
+    if (file.data) {
+#if defined(_WIN32)
+        UnmapViewOfFile(file.data);
+        CloseHandle((HANDLE)file.mappingHandle);
+        CloseHandle((HANDLE)file.fileHandle);
+#else
+        munmap(const_cast<void*>(file.data), file.size);
+#endif
+    }
+
+    file.header = nullptr;
+    file.ctrlPoints = nullptr;
+    file.data = nullptr;
+    file.size = 0;
+    file.fileHandle = nullptr;
+    file.mappingHandle = nullptr;
+}
+
+// niz [offset, offset + bytes) mora biti u fajlu i poravnat; offset 0 je dozvoljen samo za opcione nizove
+static bool validArray(const TrackFile& file, uint64_t offset, uint64_t bytes, bool required)
+{
+    if (offset == 0) return !required;
+    return offset % TRACK_FILE_ALIGN == 0 && offset >= sizeof(TrackFileHeader) &&
+           offset <= file.size && bytes <= file.size - offset;
+}
+
+bool openTrackFile(TrackFile& file, const char* path, const TrackBuildKey& key)
+{
+    closeTrackFile(file);
+    if (!mapFile(file, path)) return false;   // nema fajla - nije greska, staza se pravi ispocetka
+
+    const TrackFileHeader* h = (const TrackFileHeader*)file.data;
+    const char* problem = nullptr;
+
+    if (file.size < sizeof(TrackFileHeader) || std::memcmp(h->magic, "TRAK", 4) != 0)
+        problem = "nije fajl staze";
+    else if (h->endian != TRACK_FILE_ENDIAN)
+        problem = "drugi redosled bajtova";
+    else if (h->version != TRACK_FILE_VERSION || h->headerSize != sizeof(TrackFileHeader))
+        problem = "druga verzija formata";
+    else if (h->fileSize != file.size || h->count < 2 || h->numCtrl < 1 || h->arcTableSize < 0 ||
+             ((h->flags & TRACK_ARC_LENGTH) && h->arcTableSize < 1) ||
+             !std::isfinite(h->totalLength) || h->totalLength <= 0.0f ||
+             !std::isfinite(h->tolerance) || h->tolerance < 0.0f)
+        problem = "ostecen fajl";
+    else if (!(h->key == key))
+        problem = "napravljen od drugog rasporeda ili sa drugim podesavanjima";
+    else {
+        const uint64_t arrayBytes = (uint64_t)h->count * sizeof(float);
+        bool tangents = (h->flags & TRACK_TANGENTS) != 0;
+        bool arcLength = (h->flags & TRACK_ARC_LENGTH) != 0;
+        bool ok = validArray(file, h->ctrlOffset, (uint64_t)h->numCtrl * sizeof(Vec2), true) &&
+                  validArray(file, h->xOffset, arrayBytes, true) &&
+                  validArray(file, h->yOffset, arrayBytes, true) &&
+                  validArray(file, h->txOffset, arrayBytes, tangents) &&
+                  validArray(file, h->tyOffset, arrayBytes, tangents) &&
+                  validArray(file, h->arcLenOffset, arrayBytes, arcLength) &&
+                  validArray(file, h->arcTOffset, ((uint64_t)h->arcTableSize + 1) * sizeof(float), arcLength) &&
+                  validArray(file, h->spanOffset, arrayBytes, (h->flags & TRACK_PARAM) != 0) &&
+                  validArray(file, h->spanTOffset, arrayBytes, (h->flags & TRACK_PARAM) != 0) &&
+                  validArray(file, h->curvatureOffset, arrayBytes, (h->flags & TRACK_CURVATURE) != 0);
+        if (!ok) problem = "ostecen fajl";
+    }
+
+    if (problem) {
+        std::cout << "Fajl staze " << path << " se ne koristi: " << problem << "\n";
+        closeTrackFile(file);
+        return false;
+    }
+
+    file.header = h;
+    file.ctrlPoints = (const Vec2*)((const char*)file.data + h->ctrlOffset);
+    return true;
+}
+
+void attachTrackFile(TrackBuffer& track, const TrackFile& file)
+{
+    const TrackFileHeader* h = file.header;
+    const char* base = (const char*)file.data;
+    auto array = [&](uint64_t offset) { return offset ? (const float*)(base + offset) : nullptr; };
+
+    attachTrackView(track, h->count, array(h->xOffset), array(h->yOffset),
+        array(h->txOffset), array(h->tyOffset),
+        array(h->arcLenOffset), array(h->arcTOffset), h->arcTableSize,
+        h->totalLength);
+    track.span = h->spanOffset ? (int*)(base + h->spanOffset) : nullptr;
+    track.spanT = const_cast<float*>(array(h->spanTOffset));
+    track.curvature = const_cast<float*>(array(h->curvatureOffset));
+    track.tolerance = h->tolerance;
+}
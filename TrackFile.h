@@ -0,0 +1,93 @@
+#pragma once
+#include "Helpers.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// ================== Binarni fajl staze ==================
+// Zaglavlje, pa kontrolne tacke i sve tabele staze (x, y, tangente, duzine luka, zakrivljenost...)
+// kao goli float nizovi poravnati na 32 bajta. Fajl se ucitava mapiranjem (mmap / MapViewOfFile),
+// bez ikakvog parsiranja: TrackBuffer samo pokazuje u mapirane stranice, i sa njih ide i upload na GPU.
+// Vise procesa koji otvore isti fajl dele iste stranice (samo za citanje).
+
+const uint32_t TRACK_FILE_VERSION = 3;
+const uint32_t TRACK_FILE_ENDIAN = 0x01020304;   // citac sa drugim redosledom bajtova vidi 0x04030201
+
+// odakle su kontrolne tacke
+enum class TrackSource : uint32_t {
+    Builtin,        // TRACK_LAYOUT
+    LayoutFile,     // fajl rasporeda
+    Generated       // generateLayout
+};
+
+// Od cega i kako je staza napravljena. Fajl se koristi samo ako je kljuc isti kao sada -
+// inace bi izmena rasporeda ili podesavanja bila tiho zanemarena.
+struct TrackBuildKey {
+    uint32_t    mode;           // nacin pravljenja staze (TrackMode)
+    TrackSource source;
+    float       tolerance;      // adaptivna podela (0 = ravnomerna)
+    int32_t     segments;       // osnovni broj tacaka ravnomerne staze
+    uint64_t    sourceHash;     // hashTrackSource bajtova fajla / ugradjenog rasporeda / parametara generatora
+};
+
+bool operator==(const TrackBuildKey& a, const TrackBuildKey& b);
+
+struct TrackFileHeader {
+    char     magic[4];          // "TRAK"
+    uint32_t version;           // TRACK_FILE_VERSION
+    uint32_t endian;            // TRACK_FILE_ENDIAN
+    uint32_t headerSize;        // sizeof(TrackFileHeader)
+    uint64_t fileSize;
+
+    uint32_t flags;             // TrackBufferFlags - koji opcioni nizovi postoje
+    int32_t  numCtrl;
+    int32_t  count;
+    int32_t  arcTableSize;
+    float    totalLength;
+    float    tolerance;
+    TrackBuildKey key;
+
+    // pomeraji nizova od pocetka fajla (0 = nema niza)
+    uint64_t ctrlOffset;        // numCtrl * Vec2
+    uint64_t xOffset, yOffset;  // count float-ova
+    uint64_t txOffset, tyOffset;
+    uint64_t arcLenOffset;
+    uint64_t arcTOffset;        // arcTableSize + 1 float-ova
+    uint64_t spanOffset;        // count int32 (TRACK_PARAM)
+    uint64_t spanTOffset;
+    uint64_t curvatureOffset;
+};
+
+// Mapiran fajl staze; nizovi vaze dok se fajl ne zatvori
+struct TrackFile {
+    const TrackFileHeader* header = nullptr;
+    const Vec2* ctrlPoints = nullptr;
+
+    const void* data = nullptr;
+    size_t size = 0;
+    void* fileHandle = nullptr;      // samo Windows
+    void* mappingHandle = nullptr;   // samo Windows
+
+    TrackFile() = default;
+    ~TrackFile();
+    TrackFile(const TrackFile&) = delete;
+    TrackFile& operator=(const TrackFile&) = delete;
+};
+
+// FNV-1a; hash se moze nastaviti (prosledi prethodni)
+const uint64_t TRACK_HASH_INIT = 14695981039346656037ull;
+uint64_t hashTrackSource(const void* data, size_t bytes, uint64_t hash = TRACK_HASH_INIT);
+// hash celog fajla; false ako fajl ne moze da se otvori
+bool hashTrackSourceFile(const char* path, uint64_t& hash);
+
+// Upisuje stazu i njene kontrolne tacke (svi nizovi koje staza ima)
+bool writeTrackFile(const char* path, const TrackBuffer& track, const Vec2* ctrlPoints, int numCtrl,
+    const TrackBuildKey& key);
+
+// Mapira fajl i proverava zaglavlje; false (i poruka) ako fajl ne postoji, nije ispravan
+// ili je napravljen od necega drugog (drugi kljuc) - tada ga treba napraviti ponovo
+bool openTrackFile(TrackFile& file, const char* path, const TrackBuildKey& key);
+void closeTrackFile(TrackFile& file);
+
+// TrackBuffer koji pokazuje direktno u mapiran fajl (nista se ne kopira)
+void attachTrackFile(TrackBuffer& track, const TrackFile& file);
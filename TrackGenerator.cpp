@@ -0,0 +1,109 @@
+#include "TrackGenerator.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const float GEN_PI = 3.14159265f;
+static const Vec2  GEN_CENTER = { 0.0f, 0.15f };
+static const float GEN_RADIUS_X = 0.95f;     // osnovna elipsa (kao TRACK_LAYOUT)
+static const float GEN_RADIUS_Y = 0.50f;
+static const int   GEN_SMOOTH_PASSES = 32;
+static const float GEN_CURVATURE_SPAN = 0.002f;   // zakrivljenost se meri na bar ovolikom luku
+
+
+// [0, 1), 24 bita kao float
+static float randomFloat(uint64_t& state)
+{
+    return (float)(nextRandom(state) >> 40) / 16777216.0f;
+}
+
+// ugao i-te tacke: od levog kraja (pi) u smeru kazaljke, pa je gornja polovina prva.
+// double - sa 10 miliona tacaka korak ugla je samo par float koraka oko pi
+static double pointAngle(int i, int n)
+{
+    return 3.14159265358979 * (1.0 - 2.0 * (double)i / (double)n);
+}
+
+static Vec2 layoutPoint(double angle, float radius)
+{
+    return { GEN_CENTER.x + (float)(radius * GEN_RADIUS_X * std::cos(angle)),
+             GEN_CENTER.y + (float)(radius * GEN_RADIUS_Y * std::sin(angle)) };
+}
+
+// najveca zakrivljenost: ugao skretanja izmedju tacaka i-stride, i, i+stride / srednja duzina.
+// Sa gustim tackama float zaokruzivanje koordinata bi inace izgledalo kao ostra krivina.
+static float maxLayoutCurvature(const std::vector<Vec2>& p, int stride)
+{
+    const int n = (int)p.size();
+    float worst = 0.0f;
+    for (int i = 0; i < n; i += std::max(1, stride / 4)) {
+        const Vec2& a = p[(i + n - stride) % n];
+        const Vec2& b = p[i];
+        const Vec2& c = p[(i + stride) % n];
+        float ux = b.x - a.x, uy = b.y - a.y;
+        float vx = c.x - b.x, vy = c.y - b.y;
+        float lu = std::sqrt(ux * ux + uy * uy), lv = std::sqrt(vx * vx + vy * vy);
+        if (lu <= 0.0f || lv <= 0.0f) continue;
+        float turn = std::fabs(std::atan2(ux * vy - uy * vx, ux * vx + uy * vy));
+        worst = std::max(worst, turn / (0.5f * (lu + lv)));
+    }
+    return worst;
+}
+
+bool generateLayout(std::vector<Vec2>& ctrlPoints, const LayoutParams& params)
+{
+    const int n = std::max(params.numCtrl, 4);
+    const int numHills = params.numHills > 0 ? params.numHills : std::max(1, n / 16);
+    uint64_t state = params.seed;
+
+    // cvorovi: vrh, dolina, vrh, ... preko gornje polovine; izmedju kosinusna interpolacija
+    // (nagib 0 u cvorovima). Breg visine h na razmaku d ima zakrivljenost oko h/2 * pi^2 / d^2,
+    // pa se visina ogranicava da ne predje maxCurvature.
+    const int numKnots = 2 * numHills + 1;
+    const float knotSpacing = GEN_PI * GEN_RADIUS_X / (float)(numKnots - 1);
+    const float curvatureLimit = 2.0f * params.maxCurvature * knotSpacing * knotSpacing / (GEN_PI * GEN_PI);
+    const float amplitude = std::min(params.hillAmplitude, curvatureLimit) / GEN_RADIUS_Y;
+
+    std::vector<float> knots(numKnots);
+    for (int k = 0; k < numKnots; ++k) {
+        float r = randomFloat(state);
+        knots[k] = (k % 2 == 1) ? amplitude * (0.4f + 0.6f * r) : -0.3f * amplitude * r;
+    }
+    knots[0] = knots[numKnots - 1] = 0.0f;   // krajevi gornje polovine prelaze u elipsu
+
+    // poluprecnik po tacki (relativno na elipsu); bregovi samo gore, tezina sin^2 -> glatko na krajevima
+    std::vector<float> radius(n);
+    for (int i = 0; i < n; ++i) {
+        double angle = pointAngle(i, n);
+        float s = (float)std::sin(angle);
+        float hill = 0.0f;
+        if (s > 0.0f) {
+            float u = (float)(2.0 * i / n) * (float)(numKnots - 1);   // 0 levo .. numKnots-1 desno
+            int k = std::min((int)u, numKnots - 2);
+            float f = u - (float)k;
+            float w = 0.5f - 0.5f * std::cos(f * GEN_PI);
+            hill = (knots[k] + (knots[k + 1] - knots[k]) * w) * s * s;
+        }
+        radius[i] = std::max(1.0f + hill, 0.2f);
+    }
+
+    ctrlPoints.resize(n);
+    for (int i = 0; i < n; ++i)
+        ctrlPoints[i] = layoutPoint(pointAngle(i, n), radius[i]);
+
+    // ostatak (malo tacaka po bregu, uglovi elipse) - ravnanje poluprecnika [1 2 1] / 4
+    // dok zakrivljenost ne padne ispod granice; prosek pozitivnih ostaje pozitivan
+    const float perimeter = GEN_PI * (GEN_RADIUS_X + GEN_RADIUS_Y) * 1.2f;   // grubo, sa bregovima
+    const int stride = std::max(1, std::min(n / 8, (int)std::ceil(GEN_CURVATURE_SPAN * (float)n / perimeter)));
+    std::vector<float> smoothed(n);
+    for (int pass = 0; pass < GEN_SMOOTH_PASSES; ++pass) {
+        if (maxLayoutCurvature(ctrlPoints, stride) <= params.maxCurvature) return true;
+        for (int i = 0; i < n; ++i)
+            smoothed[i] = 0.25f * radius[(i + n - stride) % n] + 0.5f * radius[i] + 0.25f * radius[(i + stride) % n];
+        radius.swap(smoothed);
+        for (int i = 0; i < n; ++i)
+            ctrlPoints[i] = layoutPoint(pointAngle(i, n), radius[i]);
+    }
+    return maxLayoutCurvature(ctrlPoints, stride) <= params.maxCurvature;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Helpers.h"
+
+#include <cstdint>
+#include <vector>
+
+// ================== Generisan raspored (za testove opterecenja) ==================
+// Zatvoren raspored istog oblika kao TRACK_LAYOUT: gore bregovi sleva nadesno, dole ravnina nazad.
+// Tacke su na zraku iz centra (poluprecnik > 0 za svaki ugao), pa se kriva nikad ne sece sama sa sobom.
+// Isti seed daje iste tacke na svakom kompajleru (sopstveni generator, bez std:: raspodela).
+
+struct LayoutParams {
+    uint64_t seed = 1;
+    int   numCtrl = 10;             // 10 .. 10 miliona
+    int   numHills = 0;             // 0 = numCtrl / 16 (bar 1)
+    float hillAmplitude = 0.35f;    // najveca visina brega (jedinice rasporeda)
+    float maxCurvature = 12.0f;     // najveca zakrivljenost (1/poluprecnik) u tackama rasporeda
+};
+
+// Puni "ctrlPoints" (numCtrl tacaka, za buildTrackSpline / buildTrack). Visina bregova se smanjuje
+// koliko treba za maxCurvature; vraca false ako ni posle ravnanja zakrivljenost nije ispod granice.
+bool generateLayout(std::vector<Vec2>& ctrlPoints, const LayoutParams& params);
@@ -0,0 +1,172 @@
+#include "TrackGraph.h"
+#include "WorkStealing.h"
+
+#include <algorithm>
+#include <atomic>
+
+
+static EdgeEnd& nextOf(TrackGraph& graph, EdgeEnd e)
+{
+    return graph.next[2 * e.edge + e.end];
+}
+
+// kraj ivice se kaci na cvor: prvi je glavni krak, ostali grane
+static bool attachEnd(TrackGraph& graph, int node, EdgeEnd e)
+{
+    TrackNode& n = graph.nodes[node];
+    if (n.trunk.edge < 0) {
+        n.trunk = e;
+        for (int b = 0; b < n.numBranches; ++b)
+            nextOf(graph, n.branches[b]) = e;
+        if (n.numBranches > 0) nextOf(graph, e) = n.branches[n.selected];
+        return true;
+    }
+    if (n.numBranches >= MAX_SWITCH_BRANCHES) return false;
+
+    n.branches[n.numBranches++] = e;
+    nextOf(graph, e) = n.trunk;
+    if (n.numBranches == 1) nextOf(graph, n.trunk) = e;
+    return true;
+}
+
+int addTrackNode(TrackGraph& graph, Vec2 pos)
+{
+    TrackNode n;
+    n.pos = pos;
+    graph.nodes.push_back(n);
+    return (int)graph.nodes.size() - 1;
+}
+
+int addTrackEdge(TrackGraph& graph, int from, int to, const Vec2* inner, int numInner)
+{
+    const int needed = (from == to) ? 2 : 1;
+    if (graph.nodes[from].trunk.edge >= 0 && graph.nodes[from].numBranches + needed > MAX_SWITCH_BRANCHES)
+        return -1;
+    if (from != to && graph.nodes[to].trunk.edge >= 0 && graph.nodes[to].numBranches >= MAX_SWITCH_BRANCHES)
+        return -1;
+
+    const int index = (int)graph.edges.size();
+    graph.edges.emplace_back();
+    TrackEdge& e = graph.edges.back();
+    e.node[0] = from;
+    e.node[1] = to;
+    e.ctrl.push_back(graph.nodes[from].pos);
+    e.ctrl.insert(e.ctrl.end(), inner, inner + numInner);
+    if (from != to) e.ctrl.push_back(graph.nodes[to].pos);
+
+    graph.next.resize(2 * graph.edges.size());
+    attachEnd(graph, from, { index, 0 });
+    attachEnd(graph, to, { index, 1 });
+    return index;
+}
+
+// kontrolna tacka do cvora na kraju "end" - sused za nastavak krive preko cvora
+static const Vec2& pointNextToNode(const TrackEdge& e, int end)
+{
+    if (end == 0) return e.ctrl[1];
+    return (e.node[0] == e.node[1]) ? e.ctrl.back() : e.ctrl[e.ctrl.size() - 2];
+}
+
+// sused krive preko kraja "end". U skretnici svi krajevi dobijaju isti pravac d (sa glavnog kraka
+// kroz cvor): glavni krak odraz svog suseda, grana tacku 2d iza svog, pa za Catmull-Rom sve imaju
+// tangentu d i prelaz nema prelom ni za jednu izabranu granu. false = branik (odraz).
+static bool endNeighbour(const TrackGraph& graph, int edge, int end, Vec2& out)
+{
+    const TrackNode& n = graph.nodes[graph.edges[edge].node[end]];
+    if (n.trunk.edge < 0 || n.numBranches == 0) return false;
+
+    const Vec2& t = pointNextToNode(graph.edges[n.trunk.edge], n.trunk.end);
+    const Vec2 d = { n.pos.x - t.x, n.pos.y - t.y };
+    if (n.trunk.edge == edge && n.trunk.end == end) {
+        out = { n.pos.x + d.x, n.pos.y + d.y };
+    }
+    else {
+        const Vec2& b = pointNextToNode(graph.edges[edge], end);
+        out = { b.x - 2.0f * d.x, b.y - 2.0f * d.y };
+    }
+    return true;
+}
+
+bool buildTrackGraph(TrackGraph& graph, int numThreads)
+{
+    // ivice su razlicite duzine, pa niti kradu posao jedna od druge
+    std::atomic<bool> ok{ true };
+    parallelForStealing((int)graph.edges.size(), numThreads, [&](int i, int) {
+        TrackEdge& e = graph.edges[i];
+
+        if (e.node[0] == e.node[1]) {
+            // petlja - ista kriva kao glavna staza
+            if (!buildTrackSpline(e.spline, e.ctrl.data(), (int)e.ctrl.size())) {
+                ok = false;
+                return;
+            }
+        }
+        else {
+            Vec2 neighbour[2];
+            const Vec2* ends[2] = { nullptr, nullptr };
+            for (int end = 0; end < 2; ++end)
+                if (endNeighbour(graph, i, end, neighbour[end])) ends[end] = &neighbour[end];
+            buildOpenTrackSpline(e.spline, e.ctrl.data(), (int)e.ctrl.size(), ends[0], ends[1]);
+        }
+
+        if (!allocateTrack(e.track, e.spline.numCtrl * GRAPH_SEGMENTS_PER_SPAN + 1, TRACK_TANGENTS | TRACK_ARC_LENGTH)) {
+            ok = false;
+            return;
+        }
+        buildTrack(e.track, e.spline);
+    });
+    return ok;
+}
+
+void setSwitch(TrackGraph& graph, int node, int branch)
+{
+    TrackNode& n = graph.nodes[node];
+    if (branch < 0 || branch >= n.numBranches) return;
+    n.selected = branch;
+    if (n.trunk.edge >= 0) nextOf(graph, n.trunk) = n.branches[branch];
+}
+
+bool advanceOnGraph(const TrackGraph& graph, GraphPosition& pos, double distance)
+{
+    if (distance < 0.0) {
+        pos.dir = -pos.dir;
+        bool moved = advanceOnGraph(graph, pos, -distance);
+        pos.dir = -pos.dir;
+        return moved;
+    }
+
+    for (;;) {
+        const double len = graph.edges[pos.edge].track.totalLength;
+        const double target = pos.s + (double)pos.dir * distance;
+        if (target >= 0.0 && target <= len) {
+            pos.s = target;
+            return true;
+        }
+
+        // preko kraja ivice: ostatak puta prelazi na sledecu (jedno citanje tabele)
+        const int end = (target > len) ? 1 : 0;
+        distance -= end ? (len - pos.s) : pos.s;
+        const EdgeEnd to = graph.next[2 * pos.edge + end];
+        if (to.edge < 0) {
+            pos.s = end ? len : 0.0;
+            return false;
+        }
+        pos.edge = to.edge;
+        pos.s = to.end ? (double)graph.edges[to.edge].track.totalLength : 0.0;
+        pos.dir = to.end ? -1 : 1;
+    }
+}
+
+TrackFrame sampleGraphFrame(const TrackGraph& graph, const GraphPosition& pos)
+{
+    const TrackBuffer& track = graph.edges[pos.edge].track;
+
+    // arcLengthToT vrti u krug, a kraj otvorene ivice nije njen pocetak
+    float t = (pos.s >= track.totalLength) ? 1.0f : arcLengthToT((float)std::max(pos.s, 0.0), track);
+    TrackFrame f = sampleTrackFrame(t, track);
+    if (pos.dir < 0) {
+        f.tangent = { -f.tangent.x, -f.tangent.y };
+        f.normal = { -f.normal.x, -f.normal.y };
+    }
+    return f;
+}
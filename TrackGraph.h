@@ -0,0 +1,70 @@
+#pragma once
+#include "Helpers.h"
+
+#include <vector>
+
+// ================== Mreza pruga (graf sa skretnicama) ==================
+// Ivice su otvorene krive izmedju cvorova, svaka sa svojim tabelama (tangente, duzine luka).
+// Cvor je skretnica: prvi prikaceni kraj ivice je glavni krak, ostali su grane. Ko dolazi
+// glavnim krakom ide na izabranu granu, a ko dolazi granom ide na glavni krak. Cvor sa samo
+// glavnim krakom je kraj pruge (branik).
+// Izlaz preko kraja ivice je gotova tabela (next), pa prelaz je jedno citanje, bez pretrage.
+
+const int MAX_SWITCH_BRANCHES = 4;
+const int GRAPH_SEGMENTS_PER_SPAN = 16;   // tacaka tabele po rasponu ivice
+
+struct EdgeEnd {
+    int edge = -1;      // -1: nema (kraj pruge)
+    int end = 0;        // 0 = pocetak ivice, 1 = kraj
+};
+
+struct TrackNode {
+    Vec2    pos;
+    EdgeEnd trunk;                              // glavni krak
+    EdgeEnd branches[MAX_SWITCH_BRANCHES];
+    int     numBranches = 0;
+    int     selected = 0;                       // grana na koju vodi glavni krak
+};
+
+struct TrackEdge {
+    std::vector<Vec2> ctrl;   // kontrolne tacke; prva je cvor node[0] (i poslednja je node[1] osim kod petlje)
+    int node[2] = { -1, -1 };
+    TrackSpline spline;
+    TrackBuffer track;        // sopstvene tabele; t i duzina luka idu od node[0] ka node[1]
+};
+
+struct TrackGraph {
+    std::vector<TrackNode> nodes;
+    std::vector<TrackEdge> edges;
+    std::vector<EdgeEnd>   next;    // [2 * edge + end] -> ivica i kraj na koji se ulazi
+};
+
+// Polozaj vagona na grafu: ivica, predjeni put od njenog pocetka i smer kretanja.
+// Put je double - sabira se svakog koraka, pa float posle nekoliko miliona koraka odluta
+// (isti razlog kao TrackPhase na glavnoj stazi).
+struct GraphPosition {
+    int    edge = 0;
+    double s = 0.0;
+    int    dir = 1;     // +1 ka kraju ivice, -1 ka pocetku
+};
+
+int addTrackNode(TrackGraph& graph, Vec2 pos);
+
+// Ivica od cvora "from" do "to" kroz unutrasnje kontrolne tacke. from == to pravi zatvorenu petlju
+// (kao glavna staza). Vraca indeks ivice, -1 ako cvor vec ima MAX_SWITCH_BRANCHES grana.
+int addTrackEdge(TrackGraph& graph, int from, int to, const Vec2* inner, int numInner);
+
+// Pravi krive i tabele svih ivica. U skretnici glavni krak i sve grane imaju istu tangentu,
+// pa je prelaz gladak za svaki polozaj skretnice; kraj pruge je bez krivine.
+// Ivice su nezavisne (susedne se samo citaju), pa ih niti dele - numThreads 0 = sva jezgra.
+// Rezultat je isti bez obzira na broj niti.
+bool buildTrackGraph(TrackGraph& graph, int numThreads = 0);
+
+// Prebacuje skretnicu - menja samo jedan ulaz u tabeli prelaza
+void setSwitch(TrackGraph& graph, int node, int branch);
+
+// Pomera polozaj za "distance" (< 0 = unazad) preko cvorova. false ako je stao na kraju pruge.
+bool advanceOnGraph(const TrackGraph& graph, GraphPosition& pos, double distance);
+
+// Pozicija i pravac (u smeru kretanja) iz tabela ivice - isto kao na glavnoj stazi
+TrackFrame sampleGraphFrame(const TrackGraph& graph, const GraphPosition& pos);
@@ -0,0 +1,139 @@
+#include "TrackIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+// otprilike koliko duzi po celiji
+static const float SEGMENTS_PER_CELL = 2.0f;
+static const int   MAX_GRID_SIDE = 4096;
+
+
+static int clampInt(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static int cellCoord(float v, float origin, float cellSize, int cells)
+{
+    return clampInt((int)std::floor((v - origin) / cellSize), 0, cells - 1);
+}
+
+void buildTrackIndex(TrackIndex& index, const TrackBuffer& track)
+{
+    index.cellStart.clear();
+    index.segments.clear();
+    index.cols = index.rows = 0;
+    if (track.count < 2) return;
+
+    const int numSegments = track.count - 1;
+
+    float minX = track.x[0], maxX = track.x[0];
+    float minY = track.y[0], maxY = track.y[0];
+    for (int i = 1; i < track.count; ++i) {
+        minX = std::min(minX, track.x[i]); maxX = std::max(maxX, track.x[i]);
+        minY = std::min(minY, track.y[i]); maxY = std::max(maxY, track.y[i]);
+    }
+
+    // celije priblizno kvadratne, ukupno oko numSegments / SEGMENTS_PER_CELL
+    float w = std::max(maxX - minX, 1e-6f);
+    float h = std::max(maxY - minY, 1e-6f);
+    float cellSize = std::sqrt(w * h * SEGMENTS_PER_CELL / (float)numSegments);
+    cellSize = std::max(cellSize, std::max(w, h) / (float)MAX_GRID_SIDE);
+
+    index.minX = minX;
+    index.minY = minY;
+    index.cellSize = cellSize;
+    index.cols = clampInt((int)(w / cellSize) + 1, 1, MAX_GRID_SIDE);
+    index.rows = clampInt((int)(h / cellSize) + 1, 1, MAX_GRID_SIDE);
+
+    const int numCells = index.cols * index.rows;
+
+    // dva prolaza: prvo prebrojimo duzi po celiji, pa ih upisemo (jedan niz, bez vektora po celiji)
+    auto forEachCell = [&](int i, auto&& fn) {
+        int c0 = cellCoord(std::min(track.x[i], track.x[i + 1]), minX, cellSize, index.cols);
+        int c1 = cellCoord(std::max(track.x[i], track.x[i + 1]), minX, cellSize, index.cols);
+        int r0 = cellCoord(std::min(track.y[i], track.y[i + 1]), minY, cellSize, index.rows);
+        int r1 = cellCoord(std::max(track.y[i], track.y[i + 1]), minY, cellSize, index.rows);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                fn(r * index.cols + c);
+    };
+
+    index.cellStart.assign(numCells + 1, 0);
+    for (int i = 0; i < numSegments; ++i)
+        forEachCell(i, [&](int cell) { ++index.cellStart[cell + 1]; });
+
+    for (int c = 0; c < numCells; ++c)
+        index.cellStart[c + 1] += index.cellStart[c];
+
+    index.segments.resize(index.cellStart[numCells]);
+    std::vector<int> fill(index.cellStart.begin(), index.cellStart.end() - 1);
+    for (int i = 0; i < numSegments; ++i)
+        forEachCell(i, [&](int cell) { index.segments[fill[cell]++] = i; });
+}
+
+TrackProjection projectToTrack(const TrackIndex& index, const TrackBuffer& track, Vec2 point)
+{
+    TrackProjection result;
+    if (index.cols == 0 || track.count < 2) return result;
+
+    const float cs = index.cellSize;
+    const int cx = cellCoord(point.x, index.minX, cs, index.cols);
+    const int cy = cellCoord(point.y, index.minY, cs, index.rows);
+
+    float bestDist2 = -1.0f;
+
+    auto testCell = [&](int c, int r) {
+        int cell = r * index.cols + c;
+        for (int k = index.cellStart[cell]; k < index.cellStart[cell + 1]; ++k) {
+            int i = index.segments[k];
+            float ax = track.x[i], ay = track.y[i];
+            float dx = track.x[i + 1] - ax, dy = track.y[i + 1] - ay;
+            float len2 = dx * dx + dy * dy;
+            float alpha = (len2 > 0.0f) ? ((point.x - ax) * dx + (point.y - ay) * dy) / len2 : 0.0f;
+            alpha = std::min(std::max(alpha, 0.0f), 1.0f);
+
+            float px = ax + dx * alpha, py = ay + dy * alpha;
+            float d2 = (point.x - px) * (point.x - px) + (point.y - py) * (point.y - py);
+            if (bestDist2 < 0.0f || d2 < bestDist2) {
+                bestDist2 = d2;
+                result.segment = i;
+                result.t = ((float)i + alpha) / (float)(track.count - 1);
+                result.point = { px, py };
+            }
+        }
+    };
+
+    // prstenovi celija oko upita; staje kad nijedna neposecena celija ne moze biti bliza
+    for (int ring = 0; ; ++ring) {
+        int c0 = cx - ring, c1 = cx + ring;
+        int r0 = cy - ring, r1 = cy + ring;
+
+        for (int r = std::max(r0, 0); r <= std::min(r1, index.rows - 1); ++r) {
+            if (r == r0 || r == r1) {
+                for (int c = std::max(c0, 0); c <= std::min(c1, index.cols - 1); ++c)
+                    testCell(c, r);
+            }
+            else {
+                if (c0 >= 0) testCell(c0, r);
+                if (c1 < index.cols) testCell(c1, r);
+            }
+        }
+
+        // najmanja udaljenost do celija van posecenog pravougaonika (samo strane gde mreza jos ima celija)
+        float bound = -1.0f;
+        auto side = [&](bool more, float d) {
+            if (more && (bound < 0.0f || d < bound)) bound = std::max(d, 0.0f);
+        };
+        side(c0 > 0, point.x - (index.minX + (float)c0 * cs));
+        side(c1 < index.cols - 1, index.minX + (float)(c1 + 1) * cs - point.x);
+        side(r0 > 0, point.y - (index.minY + (float)r0 * cs));
+        side(r1 < index.rows - 1, index.minY + (float)(r1 + 1) * cs - point.y);
+
+        if (bound < 0.0f) break;                                        // cela mreza posecena
+        if (bestDist2 >= 0.0f && bestDist2 <= bound * bound) break;
+    }
+
+    result.distance = std::sqrt(bestDist2);
+    return result;
+}
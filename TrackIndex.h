@@ -0,0 +1,30 @@
+#pragma once
+#include "Helpers.h"
+
+#include <vector>
+
+// ================== Prostorni indeks staze ==================
+// Ravnomerna mreza preko poligonalne linije staze: svaka celija pamti duzi (i, i+1)
+// ciji pravougaonik je sece. Najbliza tacka se trazi samo u celijama oko upita,
+// pa je upit priblizno konstantan i za staze sa stotinama hiljada tacaka.
+
+struct TrackIndex {
+    float minX = 0.0f, minY = 0.0f;     // donji levi ugao mreze
+    float cellSize = 0.0f;
+    int   cols = 0, rows = 0;
+    std::vector<int> cellStart;         // duzi celije c su segments[cellStart[c] .. cellStart[c + 1])
+    std::vector<int> segments;          // indeks duzi i (od tacke i do i + 1)
+};
+
+// rezultat projekcije tacke na stazu
+struct TrackProjection {
+    float t = 0.0f;           // u [0,1], isto kao za sampleTrack
+    float distance = -1.0f;   // < 0 ako staza/indeks nisu napravljeni
+    int   segment = -1;       // duz (i, i+1) na kojoj je najbliza tacka
+    Vec2  point{};            // sama najbliza tacka
+};
+
+// pravi indeks za trenutne tacke staze (posle svake izmene staze treba ponovo)
+void buildTrackIndex(TrackIndex& index, const TrackBuffer& track);
+
+TrackProjection projectToTrack(const TrackIndex& index, const TrackBuffer& track, Vec2 point);
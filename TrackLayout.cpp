@@ -0,0 +1,154 @@
+#include "TrackLayout.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+static const size_t LAYOUT_CHUNK = 1 << 16;   // koliko se cita odjednom
+static const size_t MAX_LINE = 4096;          // duza linija je sigurno greska
+
+
+LayoutFormat layoutFormatFromPath(const char* path)
+{
+    size_t len = std::strlen(path);
+    if (len >= 4) {
+        const char* ext = path + len - 4;
+        if ((ext[0] == '.') &&
+            (ext[1] == 'c' || ext[1] == 'C') &&
+            (ext[2] == 's' || ext[2] == 'S') &&
+            (ext[3] == 'v' || ext[3] == 'V'))
+            return LayoutFormat::Csv;
+    }
+    return LayoutFormat::Text;
+}
+
+static bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+// jedan broj; from_chars ne zavisi od lokalnih podesavanja (decimalna tacka, ne zarez)
+static const char* parseNumber(const char* p, const char* end, float& out)
+{
+    if (p < end && *p == '+') ++p;     // from_chars ne prihvata '+'
+    std::from_chars_result r = std::from_chars(p, end, out);
+    if (r.ec != std::errc()) return nullptr;
+    return r.ptr;
+}
+
+enum class LineKind {
+    Empty,      // prazna ili samo komentar
+    Header,     // CSV zaglavlje
+    Point
+};
+
+// parsira jednu liniju [p, end) bez '\n'; vraca opis greske ili nullptr
+static const char* parseLine(const char* p, const char* end, LayoutFormat format,
+    bool maybeHeader, Vec2& out, LineKind& kind)
+{
+    kind = LineKind::Empty;
+
+    // komentar do kraja linije
+    const char* hash = (const char*)std::memchr(p, '#', (size_t)(end - p));
+    if (hash) end = hash;
+
+    p = skipBlanks(p, end);
+    if (p == end) return nullptr;
+
+    const char* q = parseNumber(p, end, out.x);
+    if (!q) {
+        // CSV zaglavlje: prva linija sa podacima koja ne pocinje brojem
+        if (format == LayoutFormat::Csv && maybeHeader) {
+            kind = LineKind::Header;
+            return nullptr;
+        }
+        return "ocekivan broj (x)";
+    }
+    if (!std::isfinite(out.x)) return "x nije konacan broj";   // from_chars prihvata "nan" i "inf"
+    const char* afterX = q;
+    q = skipBlanks(q, end);
+
+    if (format == LayoutFormat::Csv) {
+        if (q == end || *q != ',') return "ocekivan zarez izmedju x i y";
+        q = skipBlanks(q + 1, end);
+    }
+    else if (q == afterX) {
+        return "ocekivan razmak izmedju x i y";
+    }
+
+    const char* r = parseNumber(q, end, out.y);
+    if (!r) return "ocekivan broj (y)";
+    if (!std::isfinite(out.y)) return "y nije konacan broj";
+    if (skipBlanks(r, end) != end) return "visak podataka posle y";
+
+    kind = LineKind::Point;
+    return nullptr;
+}
+
+bool streamControlPoints(const char* path, LayoutFormat format, const std::function<void(Vec2)>& onPoint)
+{
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+
+    // deo linije koji je presecen krajem bafera se prenosi na pocetak sledeceg citanja
+    std::vector<char> buffer(LAYOUT_CHUNK + MAX_LINE);
+    size_t carried = 0;
+    int line = 0;
+    bool seenData = false;
+    const char* error = nullptr;
+    bool eof = false;
+
+    while (!error && !eof) {
+        size_t got = std::fread(buffer.data() + carried, 1, LAYOUT_CHUNK, f);
+        eof = got < LAYOUT_CHUNK;
+        const char* p = buffer.data();
+        const char* end = buffer.data() + carried + got;
+
+        for (;;) {
+            const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+            if (!nl) {
+                if (!eof || p == end) break;
+                nl = end;   // poslednja linija bez '\n'
+            }
+            ++line;
+
+            Vec2 pt;
+            LineKind kind;
+            error = parseLine(p, nl, format, !seenData, pt, kind);
+            if (error) break;
+            if (kind == LineKind::Point) onPoint(pt);
+            if (kind != LineKind::Empty) seenData = true;
+
+            p = (nl < end) ? nl + 1 : end;
+        }
+        if (error) break;
+
+        carried = (size_t)(end - p);
+        if (carried >= MAX_LINE) {
+            ++line;
+            error = "predugacka linija";
+            break;
+        }
+        std::memmove(buffer.data(), p, carried);
+    }
+
+    if (!error && std::ferror(f)) error = "greska pri citanju";
+    std::fclose(f);
+
+    if (error) {
+        std::cout << path << ":" << line << ": " << error << "\n";
+        return false;
+    }
+    return true;
+}
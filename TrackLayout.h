@@ -0,0 +1,44 @@
+#pragma once
+#include "Helpers.h"
+
+#include <array>
+#include <functional>
+
+// Kontrolne tacke pruge (grubo kao na tvojoj slici)
+constexpr int NUM_CTRL = 10;   // broj kontrolnih tacaka ugradjenog rasporeda
+constexpr std::array<Vec2, NUM_CTRL> TRACK_LAYOUT = { {
+    // leva strana – start i bregovi
+    { -0.90f, -0.30f },   // 0 start
+    { -0.65f,  0.10f },   // 1 prvi uspon
+    { -0.35f,  0.55f },   // 2 veliki vrh
+    { -0.05f,  0.05f },   // 3 dolina
+    //drugi veci breg
+    {  0.35f,  0.80f },   // 4 veliki vrh
+    {  0.60f,  0.05f },   // 5 dolina iza njega
+    // treci, uzi breg
+    {  0.85f,  0.45f },   // 6 treci vrh
+    {  0.95f,  0.00f },   // 7 spustanje
+    // dugacka donja ravnina nazad ka pocetku
+    {  0.50f, -0.35f },   // 8 donja desno
+    { -0.40f, -0.35f }    // 9 donja blizu starta (zatvaranje)
+} };
+
+// ================== Ucitavanje kontrolnih tacaka iz teksta ==================
+// Tekst:  jedna tacka po liniji, "x y" (razmaci ili tabovi)
+// CSV:    "x,y" po liniji, prva linija moze biti zaglavlje (npr. "x,y")
+// U oba formata # pocinje komentar do kraja linije, prazne linije se preskacu.
+//
+// Fajl se cita u delovima fiksne velicine i svaka tacka odmah ide u onPoint,
+// pa ni ceo fajl ni sve tacke nikad nisu u memoriji odjednom.
+
+enum class LayoutFormat {
+    Text,
+    Csv
+};
+
+// format po ekstenziji: .csv -> Csv, sve ostalo Text
+LayoutFormat layoutFormatFromPath(const char* path);
+
+// Zove onPoint za svaku tacku redom. Na prvu gresku ispisuje "fajl:linija: opis" i vraca false
+// (tacke pre greske su vec prosledjene). Ako fajl ne postoji, vraca false bez poruke o liniji.
+bool streamControlPoints(const char* path, LayoutFormat format, const std::function<void(Vec2)>& onPoint);
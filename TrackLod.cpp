@@ -0,0 +1,123 @@
+#include "TrackLod.h"
+
+#include <cmath>
+#include <utility>
+
+
+// rastojanje tacke p od duzi ab
+static float distanceToSegment(float px, float py, float ax, float ay, float bx, float by)
+{
+    float dx = bx - ax;
+    float dy = by - ay;
+    float len2 = dx * dx + dy * dy;
+    float alpha = (len2 > 0.0f) ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0f;
+    alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+
+    float ex = ax + dx * alpha - px;
+    float ey = ay + dy * alpha - py;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+// Douglas-Peucker nad indeksima "src" (vec pojednostavljen niz tacaka staze).
+// Bez rekurzije - za staze sa milionima tacaka stek bi bio preduboko.
+static void simplify(const TrackBuffer& track, const std::vector<uint32_t>& src, float tolerance,
+    std::vector<uint32_t>& out)
+{
+    const int n = (int)src.size();
+    std::vector<char> keep(n, 0);
+    keep[0] = keep[n - 1] = 1;
+
+    // zatvorena staza: prva i poslednja tacka su iste, pa prvo delimo na najdaljoj tacki od pocetka
+    std::vector<std::pair<int, int>> stack;
+    {
+        int far = 0;
+        float farDist2 = -1.0f;
+        for (int i = 1; i < n - 1; ++i) {
+            float dx = track.x[src[i]] - track.x[src[0]];
+            float dy = track.y[src[i]] - track.y[src[0]];
+            if (dx * dx + dy * dy > farDist2) {
+                farDist2 = dx * dx + dy * dy;
+                far = i;
+            }
+        }
+        if (far > 0) {
+            keep[far] = 1;
+            stack.push_back({ 0, far });
+            stack.push_back({ far, n - 1 });
+        }
+    }
+
+    while (!stack.empty()) {
+        std::pair<int, int> range = stack.back();
+        stack.pop_back();
+        int a = range.first, b = range.second;
+        if (b - a < 2) continue;
+
+        float ax = track.x[src[a]], ay = track.y[src[a]];
+        float bx = track.x[src[b]], by = track.y[src[b]];
+
+        int worst = -1;
+        float worstDist = tolerance;
+        for (int i = a + 1; i < b; ++i) {
+            float d = distanceToSegment(track.x[src[i]], track.y[src[i]], ax, ay, bx, by);
+            if (d > worstDist) {
+                worstDist = d;
+                worst = i;
+            }
+        }
+
+        if (worst >= 0) {
+            keep[worst] = 1;
+            stack.push_back({ a, worst });
+            stack.push_back({ worst, b });
+        }
+    }
+
+    out.clear();
+    for (int i = 0; i < n; ++i)
+        if (keep[i]) out.push_back(src[i]);
+}
+
+void buildTrackLod(TrackLod& lod, const TrackBuffer& track)
+{
+    lod.levels.clear();
+    lod.indices.clear();
+    if (track.count < 2) return;
+
+    // nivo 0: sve tacke
+    std::vector<uint32_t> level(track.count), next;
+    for (int i = 0; i < track.count; ++i) level[i] = (uint32_t)i;
+
+    // svaki nivo se pravi od prethodnog, pa se greske sabiraju
+    float error = 0.0f;
+    for (int k = 0; k < TRACK_LOD_LEVELS; ++k) {
+        if (k > 0) {
+            float tolerance = TRACK_LOD_BASE_TOLERANCE * (float)(1 << (k - 1));
+            simplify(track, level, tolerance, next);
+            if (next.size() == level.size()) continue;   // isti kao prethodni, samo veca tolerancija
+            level.swap(next);
+            error += tolerance;
+        }
+
+        TrackLodLevel l;
+        l.tolerance = error;
+        l.first = (int)lod.indices.size();
+        l.count = (int)level.size();
+        lod.levels.push_back(l);
+        lod.indices.insert(lod.indices.end(), level.begin(), level.end());
+
+        if (level.size() <= 8) break;   // grublje nema smisla
+    }
+}
+
+int selectTrackLod(const TrackLod& lod, float unitsPerPixel)
+{
+    const float maxError = 0.5f * unitsPerPixel;
+
+    int best = 0;
+    for (int k = 1; k < (int)lod.levels.size(); ++k) {
+        if (lod.levels[k].tolerance > maxError) break;
+        best = k;
+    }
+    return best;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Helpers.h"
+
+#include <cstdint>
+#include <vector>
+
+// ================== Nivoi detalja za sine ==================
+// Lanac pojednostavljenih verzija poligonalne linije staze (Douglas-Peucker sa sve vecom
+// tolerancijom). Svaki nivo je lista indeksa u postojeci VBO staze, pa se crta sa glDrawElements
+// bez ikakvih novih temena; bira se nivo cija greska je ispod pola piksela na ekranu.
+
+const int   TRACK_LOD_LEVELS = 6;
+const float TRACK_LOD_BASE_TOLERANCE = 0.0005f;    // nivo 1; svaki sledeci 2x grublji
+
+struct TrackLodLevel {
+    float tolerance;    // najvece odstupanje od pune staze (nivo 0 = 0)
+    int   first;        // pocetak u indices
+    int   count;
+};
+
+struct TrackLod {
+    std::vector<TrackLodLevel> levels;   // od najfinijeg (sve tacke) ka najgrubljem
+    std::vector<uint32_t> indices;       // svi nivoi jedan za drugim (za jedan element buffer)
+};
+
+// Pravi sve nivoe za trenutne tacke staze; svaki nivo je podskup prethodnog
+void buildTrackLod(TrackLod& lod, const TrackBuffer& track);
+
+// Najgrublji nivo cija greska ne prelazi pola piksela (unitsPerPixel = velicina piksela u jedinicama staze)
+int selectTrackLod(const TrackLod& lod, float unitsPerPixel);
@@ -0,0 +1,48 @@
+#pragma once
+#include "Helpers.h"
+
+#include <cmath>
+#include <cstdint>
+
+// ================== Polozaj na stazi kao fiksni zarez ==================
+// Gornja 32 bita = broj krugova, donja 32 bita = deo kruga (deo ukupne duzine staze).
+// Prelazak preko kraja staze je obican prenos u gornji deo, pa nema "if (t > 1) t -= 1"
+// i krug se broji tacno; unazad preko pocetka oduzima krug. Korak je 1/2^32 kruga
+// (za stazu od 1 km to je ispod mikrometra), isti na celoj stazi.
+typedef uint64_t TrackPhase;
+
+const double PHASE_ONE_LAP = 4294967296.0;   // 2^32
+
+// broj predjenih krugova (moze da se prelije - porede se samo promene)
+inline uint32_t phaseLaps(TrackPhase phase)
+{
+    return (uint32_t)(phase >> 32);
+}
+
+// deo kruga u [0,1)
+inline double phaseFraction(TrackPhase phase)
+{
+    return (double)(uint32_t)phase / PHASE_ONE_LAP;
+}
+
+// pomeraj za predjeni put "distance" (moze i negativan - tada se sabira kao komplement)
+inline TrackPhase phaseStep(double distance, float totalLength)
+{
+    if (totalLength <= 0.0f) return 0;
+    return (TrackPhase)(int64_t)std::llround(distance / (double)totalLength * PHASE_ONE_LAP);
+}
+
+// polozaj -> t za sampleTrack / trackAngle; indeks u tabeli duzina se dobija celobrojno,
+// pa preciznost ne zavisi od duzine staze
+inline float phaseToT(TrackPhase phase, const TrackBuffer& track)
+{
+    const uint32_t fraction = (uint32_t)phase;
+    if (!track.hasArcLength() || track.arcTableSize <= 0)
+        return (float)phaseFraction(phase);
+
+    // fraction * tableSize: gornjih 32 bita = indeks, donjih 32 = polozaj unutar dela tabele
+    uint64_t scaled = (uint64_t)fraction * (uint64_t)track.arcTableSize;
+    int   k = (int)(scaled >> 32);
+    float alpha = (float)((double)(uint32_t)scaled / PHASE_ONE_LAP);
+    return track.arcT[k] + (track.arcT[k + 1] - track.arcT[k]) * alpha;
+}
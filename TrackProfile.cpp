@@ -0,0 +1,26 @@
+#include "TrackProfile.h"
+
+
+void buildTrackProfile(TrackProfile& profile, const TrackBuffer& track, const TrackSpline& spline)
+{
+    profile.samples.clear();
+    profile.size = 0;
+    profile.totalLength = track.totalLength;
+    if (!track.hasArcLength() || track.arcTableSize <= 0) return;
+
+    const int size = track.arcTableSize;
+    profile.size = size;
+    profile.samples.resize(size + 1);
+
+    // tabela duzina daje t za svako rastojanje, a vrednosti se uzimaju tacno sa krive
+    for (int k = 0; k <= size; ++k) {
+        SplinePos pos = trackTToSplinePos(track.arcT[k], track, spline.numCtrl);
+        TrackFrame frame = splineFrame(spline, pos);
+
+        ProfileSample& p = profile.samples[k];
+        p.height = frame.pos.y;
+        p.slope = frame.tangent.y;
+        p.curvature = splineCurvature(spline, pos);
+        p.pad = 0.0f;
+    }
+}
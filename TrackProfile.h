@@ -0,0 +1,45 @@
+#pragma once
+#include "Helpers.h"
+#include "TrackPhase.h"
+
+#include <vector>
+
+// ================== Profil staze za fiziku ==================
+// Visina, nagib i zakrivljenost na ravnomernim rastojanjima duz staze (ista gustina kao tabela
+// duzina luka). Fizika jednim citanjem (dva susedna zapisa + lerp) dobija sve sto joj treba,
+// bez tangenti, sin/atan2 i pretrage po stazi.
+
+// jedan zapis - sve tri vrednosti zajedno, jer se uvek citaju zajedno
+struct ProfileSample {
+    float height;       // y staze
+    float slope;        // sin ugla nagiba (y jedinicne tangente); > 0 = uzbrdo u smeru voznje
+    float curvature;    // 1/poluprecnik, > 0 kad staza skrece levo (nagore za smer voznje)
+    float pad;          // 16 bajtova po zapisu
+};
+
+struct TrackProfile {
+    float totalLength = 0.0f;
+    int   size = 0;                       // broj delova; zapisa ima size + 1 (poslednji = prvi)
+    std::vector<ProfileSample> samples;
+};
+
+// Pravi profil za vec napravljenu stazu: rastojanja iz njene tabele duzina luka,
+// a visina / nagib / zakrivljenost tacno sa krive (adaptivnoj stazi treba TRACK_PARAM)
+void buildTrackProfile(TrackProfile& profile, const TrackBuffer& track, const TrackSpline& spline);
+
+// Profil na polozaju phase (indeks celobrojno, kao phaseToT)
+inline ProfileSample sampleProfile(const TrackProfile& profile, TrackPhase phase)
+{
+    uint64_t scaled = (uint64_t)(uint32_t)phase * (uint64_t)profile.size;
+    int   k = (int)(scaled >> 32);
+    float alpha = (float)((double)(uint32_t)scaled / PHASE_ONE_LAP);
+
+    const ProfileSample& a = profile.samples[k];
+    const ProfileSample& b = profile.samples[k + 1];
+    ProfileSample r;
+    r.height = a.height + (b.height - a.height) * alpha;
+    r.slope = a.slope + (b.slope - a.slope) * alpha;
+    r.curvature = a.curvature + (b.curvature - a.curvature) * alpha;
+    r.pad = 0.0f;
+    return r;
+}
@@ -0,0 +1,53 @@
+#include "TrackQuant.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool quantizeTrackChunks(QuantTrack& quant, const TrackBuffer& track, int firstChunk, int lastChunk)
+{
+    quant.firstChunk = firstChunk;
+    quant.count = 0;
+    quant.chunks.clear();
+    quant.dx.clear();
+    quant.dy.clear();
+    if (track.count < 2) return false;
+
+    const int count = track.count;
+    lastChunk = std::min(lastChunk, (count + QUANT_CHUNK_POINTS - 1) / QUANT_CHUNK_POINTS);
+    if (firstChunk < 0 || firstChunk >= lastChunk) return false;
+
+    const int base = firstChunk * QUANT_CHUNK_POINTS;
+    const int end = std::min(count, lastChunk * QUANT_CHUNK_POINTS);
+    quant.chunks.resize(lastChunk - firstChunk);
+    quant.dx.resize(end - base);
+    quant.dy.resize(end - base);
+
+    for (int k = firstChunk; k < lastChunk; ++k) {
+        const int first = k * QUANT_CHUNK_POINTS;
+        const int last = std::min(count, first + QUANT_CHUNK_POINTS);
+
+        // ishodiste = sredina okvira, pa pomaci koriste ceo opseg [-32767, 32767]
+        float minX = track.x[first], maxX = minX, minY = track.y[first], maxY = minY;
+        for (int i = first + 1; i < last; ++i) {
+            minX = std::min(minX, track.x[i]); maxX = std::max(maxX, track.x[i]);
+            minY = std::min(minY, track.y[i]); maxY = std::max(maxY, track.y[i]);
+        }
+        QuantChunk& c = quant.chunks[k - firstChunk];
+        c.originX = 0.5f * (minX + maxX);
+        c.originY = 0.5f * (minY + maxY);
+        float extent = 0.5f * std::max(maxX - minX, maxY - minY);
+        c.step = (extent > 0.0f) ? extent / 32767.0f : 1.0f;
+        c.pad = 0.0f;
+
+        const float inv = 1.0f / c.step;
+        for (int i = first; i < last; ++i) {
+            float qx = std::round((track.x[i] - c.originX) * inv);
+            float qy = std::round((track.y[i] - c.originY) * inv);
+            quant.dx[i - base] = (int16_t)std::min(std::max(qx, -32767.0f), 32767.0f);
+            quant.dy[i - base] = (int16_t)std::min(std::max(qy, -32767.0f), 32767.0f);
+        }
+    }
+
+    quant.count = end - base;
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "Helpers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ================== Sabijena staza (16 bita po vrednosti) ==================
+// Tacke se dele na delove od QUANT_CHUNK_POINTS; svaki deo ima svoje ishodiste i korak,
+// a tacka pamti samo 16-bitni pomak od ishodista. Sabija se samo ono sto ide na GPU (4 bajta po
+// tacki umesto 8), dekodira ga track_q.vert. Fizika, profil i indeks citaju float stazu.
+
+const int QUANT_CHUNK_POINTS = 256;
+
+// jedan texel (RGBA32F) u buffer teksturi za sejder
+struct QuantChunk {
+    float originX, originY;   // sredina okvira dela
+    float step;               // jedinica staze po jednom koraku pomaka
+    float pad;
+};
+
+struct QuantTrack {
+    int firstChunk = 0;                // prvi deo staze (quantizeTrackChunks), 0 za celu stazu
+    int count = 0;
+    std::vector<QuantChunk> chunks;    // (count + QUANT_CHUNK_POINTS - 1) / QUANT_CHUNK_POINTS
+    std::vector<int16_t>  dx, dy;      // pomak od ishodista dela, u koracima
+};
+
+// Sabija delove [firstChunk, lastChunk) vec napravljene staze (0 i broj delova za celu stazu);
+// chunks, dx i dy pocinju od firstChunk. Greska pozicije je najvise pola koraka dela.
+bool quantizeTrackChunks(QuantTrack& quant, const TrackBuffer& track, int firstChunk, int lastChunk);
+
+// Isto sto racuna track_q.vert; i je indeks od pocetka firstChunk dela
+inline Vec2 quantPoint(const QuantTrack& quant, int i)
+{
+    const QuantChunk& c = quant.chunks[i / QUANT_CHUNK_POINTS];
+    return { c.originX + (float)quant.dx[i] * c.step, c.originY + (float)quant.dy[i] * c.step };
+}
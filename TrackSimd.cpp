@@ -0,0 +1,326 @@
+#include "TrackSimd.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRACK_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC sme AVX instrukcije bez posebnog flega, GCC/Clang traze target atribut
+#if defined(TRACK_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TRACK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TRACK_TARGET_AVX2
+#endif
+
+
+SimdLevel detectSimdLevel()
+{
+#if defined(TRACK_SIMD_X86)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx) {
+        // OS mora da cuva YMM registre
+        bool ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2) return SimdLevel::AVX2;
+    if (sse2) return SimdLevel::SSE2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+#endif
+    return SimdLevel::Scalar;
+}
+
+
+// ================== Skalarna varijanta (i za ostatak posle SIMD petlje) ==================
+static void evalSpanScalar(const SpanCoeffs& c, int first, int last,
+    float denom, float numCtrl, float span,
+    float* x, float* y, float* tx, float* ty)
+{
+    for (int i = first; i < last; ++i) {
+        float u = (float)i / denom;
+        float t = u * numCtrl - span;
+
+        // Horner: a + t*(b + t*(c + t*d))
+        Vec2 p = spanPoint(c, t);
+        x[i] = p.x;
+        y[i] = p.y;
+
+        if (tx) {
+            // izvod: b + t*(2c + t*3d)
+            Vec2 d = spanDerivative(c, t);
+            float dx = d.x;
+            float dy = d.y;
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len > 0.0f) {
+                dx = dx / len;
+                dy = dy / len;
+            }
+            tx[i] = dx;
+            ty[i] = dy;
+        }
+    }
+}
+
+
+#if defined(TRACK_SIMD_X86)
+// ================== SSE2 - 4 uzorka odjednom ==================
+static void evalSpanSSE2(const SpanCoeffs& c, int first, int last,
+    float denom, float numCtrl, float span,
+    float* x, float* y, float* tx, float* ty)
+{
+    const __m128 vDenom = _mm_set1_ps(denom);
+    const __m128 vNum = _mm_set1_ps(numCtrl);
+    const __m128 vSpan = _mm_set1_ps(span);
+    const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    const __m128 ax = _mm_set1_ps(c.ax), bx = _mm_set1_ps(c.bx), cx = _mm_set1_ps(c.cx), dx = _mm_set1_ps(c.dx);
+    const __m128 ay = _mm_set1_ps(c.ay), by = _mm_set1_ps(c.by), cy = _mm_set1_ps(c.cy), dy = _mm_set1_ps(c.dy);
+
+    int i = first;
+    for (; i + 4 <= last; i += 4) {
+        __m128 fi = _mm_add_ps(_mm_set1_ps((float)i), lane);
+        __m128 t = _mm_sub_ps(_mm_mul_ps(_mm_div_ps(fi, vDenom), vNum), vSpan);
+
+        _mm_storeu_ps(x + i, _mm_add_ps(ax, _mm_mul_ps(t, _mm_add_ps(bx, _mm_mul_ps(t, _mm_add_ps(cx, _mm_mul_ps(t, dx)))))));
+        _mm_storeu_ps(y + i, _mm_add_ps(ay, _mm_mul_ps(t, _mm_add_ps(by, _mm_mul_ps(t, _mm_add_ps(cy, _mm_mul_ps(t, dy)))))));
+
+        if (tx) {
+            __m128 gx = _mm_add_ps(bx, _mm_mul_ps(t, _mm_add_ps(_mm_mul_ps(two, cx), _mm_mul_ps(t, _mm_mul_ps(three, dx)))));
+            __m128 gy = _mm_add_ps(by, _mm_mul_ps(t, _mm_add_ps(_mm_mul_ps(two, cy), _mm_mul_ps(t, _mm_mul_ps(three, dy)))));
+            __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)));
+
+            // deli samo gde je duzina > 0 (SSE2 nema blend, pa and/andnot)
+            __m128 ok = _mm_cmpgt_ps(len, zero);
+            _mm_storeu_ps(tx + i, _mm_or_ps(_mm_and_ps(ok, _mm_div_ps(gx, len)), _mm_andnot_ps(ok, gx)));
+            _mm_storeu_ps(ty + i, _mm_or_ps(_mm_and_ps(ok, _mm_div_ps(gy, len)), _mm_andnot_ps(ok, gy)));
+        }
+    }
+
+    evalSpanScalar(c, i, last, denom, numCtrl, span, x, y, tx, ty);
+}
+
+
+// ================== AVX2 - 8 uzoraka odjednom ==================
+TRACK_TARGET_AVX2
+static void evalSpanAVX2(const SpanCoeffs& c, int first, int last,
+    float denom, float numCtrl, float span,
+    float* x, float* y, float* tx, float* ty)
+{
+    const __m256 vDenom = _mm256_set1_ps(denom);
+    const __m256 vNum = _mm256_set1_ps(numCtrl);
+    const __m256 vSpan = _mm256_set1_ps(span);
+    const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 three = _mm256_set1_ps(3.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    const __m256 ax = _mm256_set1_ps(c.ax), bx = _mm256_set1_ps(c.bx), cx = _mm256_set1_ps(c.cx), dx = _mm256_set1_ps(c.dx);
+    const __m256 ay = _mm256_set1_ps(c.ay), by = _mm256_set1_ps(c.by), cy = _mm256_set1_ps(c.cy), dy = _mm256_set1_ps(c.dy);
+
+    // bez FMA, da rezultat bude isti kao u skalarnoj i SSE2 varijanti
+    int i = first;
+    for (; i + 8 <= last; i += 8) {
+        __m256 fi = _mm256_add_ps(_mm256_set1_ps((float)i), lane);
+        __m256 t = _mm256_sub_ps(_mm256_mul_ps(_mm256_div_ps(fi, vDenom), vNum), vSpan);
+
+        _mm256_storeu_ps(x + i, _mm256_add_ps(ax, _mm256_mul_ps(t, _mm256_add_ps(bx, _mm256_mul_ps(t, _mm256_add_ps(cx, _mm256_mul_ps(t, dx)))))));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(ay, _mm256_mul_ps(t, _mm256_add_ps(by, _mm256_mul_ps(t, _mm256_add_ps(cy, _mm256_mul_ps(t, dy)))))));
+
+        if (tx) {
+            __m256 gx = _mm256_add_ps(bx, _mm256_mul_ps(t, _mm256_add_ps(_mm256_mul_ps(two, cx), _mm256_mul_ps(t, _mm256_mul_ps(three, dx)))));
+            __m256 gy = _mm256_add_ps(by, _mm256_mul_ps(t, _mm256_add_ps(_mm256_mul_ps(two, cy), _mm256_mul_ps(t, _mm256_mul_ps(three, dy)))));
+            __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(gx, gx), _mm256_mul_ps(gy, gy)));
+
+            __m256 ok = _mm256_cmp_ps(len, zero, _CMP_GT_OQ);
+            _mm256_storeu_ps(tx + i, _mm256_blendv_ps(gx, _mm256_div_ps(gx, len), ok));
+            _mm256_storeu_ps(ty + i, _mm256_blendv_ps(gy, _mm256_div_ps(gy, len), ok));
+        }
+    }
+
+    evalSpanSSE2(c, i, last, denom, numCtrl, span, x, y, tx, ty);
+}
+#endif
+
+
+void evalSpan(SimdLevel level, const SpanCoeffs& c, int first, int last,
+    float denom, float numCtrl, float span,
+    float* x, float* y, float* tx, float* ty)
+{
+#if defined(TRACK_SIMD_X86)
+    if (level == SimdLevel::AVX2) {
+        evalSpanAVX2(c, first, last, denom, numCtrl, span, x, y, tx, ty);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        evalSpanSSE2(c, first, last, denom, numCtrl, span, x, y, tx, ty);
+        return;
+    }
+#endif
+    evalSpanScalar(c, first, last, denom, numCtrl, span, x, y, tx, ty);
+}
+
+
+// ================== Uzorci za vise t odjednom ==================
+// indeksi kao u sampleTrack: t <= 0 -> tacka 0, t >= 1 -> poslednja, inace lerp izmedju i0 i i0+1
+static void sampleTrackBatchScalar(const TrackBuffer& track, const float* t, int first, int n,
+    float* x, float* y, float* tx, float* ty)
+{
+    const int last = track.count - 1;
+    const float fLast = (float)last;
+
+    for (int k = first; k < n; ++k) {
+        float fIndex = t[k] * fLast;
+        fIndex = fIndex > 0.0f ? fIndex : 0.0f;
+        fIndex = fIndex < fLast ? fIndex : fLast;
+        int   i0 = (int)fIndex;
+        int   i1 = i0 < last ? i0 + 1 : last;
+        float alpha = fIndex - (float)i0;
+
+        x[k] = track.x[i0] + (track.x[i1] - track.x[i0]) * alpha;
+        y[k] = track.y[i0] + (track.y[i1] - track.y[i0]) * alpha;
+
+        if (tx) {
+            float gx = track.tx[i0] + (track.tx[i1] - track.tx[i0]) * alpha;
+            float gy = track.ty[i0] + (track.ty[i1] - track.ty[i0]) * alpha;
+            float len = std::sqrt(gx * gx + gy * gy);
+            if (len > 0.0f) {
+                gx = gx / len;
+                gy = gy / len;
+            }
+            tx[k] = gx;
+            ty[k] = gy;
+        }
+    }
+}
+
+
+#if defined(TRACK_SIMD_X86)
+// SSE2 nema gather - indeksi se izvuku i cita se pojedinacno, a racuna se 4 odjednom
+static __m128 gatherSSE2(const float* base, const int* idx)
+{
+    return _mm_setr_ps(base[idx[0]], base[idx[1]], base[idx[2]], base[idx[3]]);
+}
+
+static void sampleTrackBatchSSE2(const TrackBuffer& track, const float* t, int first, int n,
+    float* x, float* y, float* tx, float* ty)
+{
+    const int last = track.count - 1;
+    const __m128 fLast = _mm_set1_ps((float)last);
+    const __m128i iLast = _mm_set1_epi32(last);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 zero = _mm_setzero_ps();
+
+    int k = first;
+    alignas(16) int i0s[4], i1s[4];
+    for (; k + 4 <= n; k += 4) {
+        __m128 fIndex = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(t + k), fLast), zero), fLast);
+        __m128i i0 = _mm_cvttps_epi32(fIndex);
+        // i1 = i0 + 1, ali ne preko poslednje tacke (SSE2 nema min_epi32)
+        __m128i atEnd = _mm_cmpeq_epi32(i0, iLast);
+        __m128i i1 = _mm_sub_epi32(_mm_add_epi32(i0, one), _mm_and_si128(atEnd, one));
+        __m128 alpha = _mm_sub_ps(fIndex, _mm_cvtepi32_ps(i0));
+        _mm_store_si128((__m128i*)i0s, i0);
+        _mm_store_si128((__m128i*)i1s, i1);
+
+        __m128 x0 = gatherSSE2(track.x, i0s), x1 = gatherSSE2(track.x, i1s);
+        __m128 y0 = gatherSSE2(track.y, i0s), y1 = gatherSSE2(track.y, i1s);
+        _mm_storeu_ps(x + k, _mm_add_ps(x0, _mm_mul_ps(_mm_sub_ps(x1, x0), alpha)));
+        _mm_storeu_ps(y + k, _mm_add_ps(y0, _mm_mul_ps(_mm_sub_ps(y1, y0), alpha)));
+
+        if (tx) {
+            __m128 a0 = gatherSSE2(track.tx, i0s), a1 = gatherSSE2(track.tx, i1s);
+            __m128 b0 = gatherSSE2(track.ty, i0s), b1 = gatherSSE2(track.ty, i1s);
+            __m128 gx = _mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(a1, a0), alpha));
+            __m128 gy = _mm_add_ps(b0, _mm_mul_ps(_mm_sub_ps(b1, b0), alpha));
+            __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)));
+
+            __m128 ok = _mm_cmpgt_ps(len, zero);
+            _mm_storeu_ps(tx + k, _mm_or_ps(_mm_and_ps(ok, _mm_div_ps(gx, len)), _mm_andnot_ps(ok, gx)));
+            _mm_storeu_ps(ty + k, _mm_or_ps(_mm_and_ps(ok, _mm_div_ps(gy, len)), _mm_andnot_ps(ok, gy)));
+        }
+    }
+
+    sampleTrackBatchScalar(track, t, k, n, x, y, tx, ty);
+}
+
+
+TRACK_TARGET_AVX2
+static void sampleTrackBatchAVX2(const TrackBuffer& track, const float* t, int first, int n,
+    float* x, float* y, float* tx, float* ty)
+{
+    const int last = track.count - 1;
+    const __m256 fLast = _mm256_set1_ps((float)last);
+    const __m256i iLast = _mm256_set1_epi32(last);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int k = first;
+    for (; k + 8 <= n; k += 8) {
+        __m256 fIndex = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(t + k), fLast), zero), fLast);
+        __m256i i0 = _mm256_cvttps_epi32(fIndex);
+        __m256i i1 = _mm256_min_epi32(_mm256_add_epi32(i0, one), iLast);
+        __m256 alpha = _mm256_sub_ps(fIndex, _mm256_cvtepi32_ps(i0));
+
+        __m256 x0 = _mm256_i32gather_ps(track.x, i0, 4), x1 = _mm256_i32gather_ps(track.x, i1, 4);
+        __m256 y0 = _mm256_i32gather_ps(track.y, i0, 4), y1 = _mm256_i32gather_ps(track.y, i1, 4);
+        _mm256_storeu_ps(x + k, _mm256_add_ps(x0, _mm256_mul_ps(_mm256_sub_ps(x1, x0), alpha)));
+        _mm256_storeu_ps(y + k, _mm256_add_ps(y0, _mm256_mul_ps(_mm256_sub_ps(y1, y0), alpha)));
+
+        if (tx) {
+            __m256 a0 = _mm256_i32gather_ps(track.tx, i0, 4), a1 = _mm256_i32gather_ps(track.tx, i1, 4);
+            __m256 b0 = _mm256_i32gather_ps(track.ty, i0, 4), b1 = _mm256_i32gather_ps(track.ty, i1, 4);
+            __m256 gx = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_sub_ps(a1, a0), alpha));
+            __m256 gy = _mm256_add_ps(b0, _mm256_mul_ps(_mm256_sub_ps(b1, b0), alpha));
+            __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(gx, gx), _mm256_mul_ps(gy, gy)));
+
+            __m256 ok = _mm256_cmp_ps(len, zero, _CMP_GT_OQ);
+            _mm256_storeu_ps(tx + k, _mm256_blendv_ps(gx, _mm256_div_ps(gx, len), ok));
+            _mm256_storeu_ps(ty + k, _mm256_blendv_ps(gy, _mm256_div_ps(gy, len), ok));
+        }
+    }
+
+    sampleTrackBatchSSE2(track, t, k, n, x, y, tx, ty);
+}
+#endif
+
+
+void sampleTrackBatch(SimdLevel level, const TrackBuffer& track, const float* t, int n,
+    float* x, float* y, float* tx, float* ty)
+{
+    if (n <= 0 || track.count < 2) return;
+
+#if defined(TRACK_SIMD_X86)
+    if (level == SimdLevel::AVX2) {
+        sampleTrackBatchAVX2(track, t, 0, n, x, y, tx, ty);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        sampleTrackBatchSSE2(track, t, 0, n, x, y, tx, ty);
+        return;
+    }
+#endif
+    sampleTrackBatchScalar(track, t, 0, n, x, y, tx, ty);
+}
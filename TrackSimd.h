@@ -0,0 +1,24 @@
+#pragma once
+#include "Helpers.h"
+
+// Koji skup instrukcija koristimo - bira se jednom, pri pokretanju
+enum class SimdLevel {
+    Scalar,
+    SSE2,   // 4 uzorka odjednom
+    AVX2    // 8 uzoraka odjednom
+};
+
+SimdLevel detectSimdLevel();
+
+// Racuna uzorke [first, last) koji svi padaju u raspon "span".
+// Parametar uzorka i je (i / denom) * numCtrl - span, isto kao u buildTrack.
+// Izlaz je SoA (x[], y[]); tx / ty mogu biti nullptr. Sve varijante daju identicne rezultate.
+void evalSpan(SimdLevel level, const SpanCoeffs& c, int first, int last,
+    float denom, float numCtrl, float span,
+    float* x, float* y, float* tx, float* ty);
+
+// Vise tacaka staze odjednom (npr. hiljade vagona): za svako t[k] isto sto i sampleTrack,
+// a ako tx != nullptr i jedinicna tangenta kao u sampleTrackFrame (normala je (-ty, tx)).
+// Izlaz je SoA. Staza mora imati tangente ako se traze. Sve varijante daju identicne rezultate.
+void sampleTrackBatch(SimdLevel level, const TrackBuffer& track, const float* t, int n,
+    float* x, float* y, float* tx, float* ty);
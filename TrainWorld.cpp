@@ -0,0 +1,213 @@
+#include "TrainWorld.h"
+#include "WorkStealing.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+int addTrains(TrainWorld& world, int n)
+{
+    const int first = world.count;
+    world.count += n;
+    const size_t size = (size_t)world.count;
+
+    world.phase.resize(size, 0);
+    world.prevPhase.resize(size, 0);
+    world.speed.resize(size, 0.0f);
+    world.pauseTimer.resize(size, 0.0);
+    world.state.resize(size, (uint8_t)RideState::BOARDING);
+    world.returningForward.resize(size, 0);
+    world.clearing.resize(size, 0);
+    world.present.resize(size, 0);
+    world.belted.resize(size, 0);
+    world.sick.resize(size, 0);
+    world.sickSeat.resize(size, -1);
+    world.finishedRides.resize(size, 0);
+    return first;
+}
+
+Ride loadTrain(const TrainWorld& world, int train)
+{
+    Ride ride;
+    for (int s = 0; s < MAX_SEATS; ++s) {
+        ride.passengers[s].present = (world.present[train] >> s) & 1;
+        ride.passengers[s].beltOn = (world.belted[train] >> s) & 1;
+        ride.passengers[s].sick = (world.sick[train] >> s) & 1;
+        ride.passengerCount += ride.passengers[s].present ? 1 : 0;
+    }
+    ride.phase = world.phase[train];
+    ride.prevPhase = world.prevPhase[train];
+    ride.speed = world.speed[train];
+    ride.state = (RideState)world.state[train];
+    ride.clearingPassengers = world.clearing[train] != 0;
+    ride.sickPauseTimer = world.pauseTimer[train];
+    ride.sickPassengerIndex = world.sickSeat[train];
+    ride.returningForward = world.returningForward[train] != 0;
+    ride.finishedRides = world.finishedRides[train];
+    return ride;
+}
+
+void storeTrain(TrainWorld& world, int train, const Ride& ride)
+{
+    uint8_t present = 0, belted = 0, sick = 0;
+    for (int s = 0; s < MAX_SEATS; ++s) {
+        present |= (uint8_t)(ride.passengers[s].present ? 1 << s : 0);
+        belted |= (uint8_t)(ride.passengers[s].beltOn ? 1 << s : 0);
+        sick |= (uint8_t)(ride.passengers[s].sick ? 1 << s : 0);
+    }
+    world.present[train] = present;
+    world.belted[train] = belted;
+    world.sick[train] = sick;
+    world.phase[train] = ride.phase;
+    world.prevPhase[train] = ride.prevPhase;
+    world.speed[train] = ride.speed;
+    world.state[train] = (uint8_t)ride.state;
+    world.clearing[train] = ride.clearingPassengers ? 1 : 0;
+    world.pauseTimer[train] = ride.sickPauseTimer;
+    world.sickSeat[train] = (int8_t)ride.sickPassengerIndex;
+    world.returningForward[train] = ride.returningForward ? 1 : 0;
+    world.finishedRides[train] = ride.finishedRides;
+}
+
+// Parametri koraka - racunaju se jednom za ceo opseg vozova
+struct TrainStep {
+    double dt, length, returnStep;
+    float  dtf, startStep, brakeStep, targetSpeed, runningSpeed;
+    float  uphillBrake, downhillAccel, minSpeed, maxSpeed, friction;
+};
+
+static TrainStep makeTrainStep(const TrackProfile& profile, const RideParams& params, double dt)
+{
+    TrainStep c;
+    c.dt = dt;
+    c.length = (double)profile.totalLength;
+    c.returnStep = params.returnSpeed * dt;
+    c.dtf = (float)dt;
+    c.startStep = params.startAccel * c.dtf;
+    c.brakeStep = params.brakeAccel * c.dtf;
+    c.targetSpeed = params.targetSpeed;
+    c.runningSpeed = params.targetSpeed * 0.999f;
+    c.uphillBrake = params.gravityAccel * params.uphillBrake;
+    c.downhillAccel = params.gravityAccel * params.downhillAccel;
+    c.minSpeed = params.minSpeed;
+    c.maxSpeed = params.maxSpeed;
+    c.friction = params.friction;
+    return c;
+}
+
+// llround bez poziva biblioteke (polovina dalje od nule) - x - trunc(x) je tacno
+static inline int64_t roundStep(double x)
+{
+    const int64_t whole = (int64_t)x;              // odseca ka nuli
+    const double part = x - (double)whole;
+    return whole + (int64_t)(part >= 0.5) - (int64_t)(part <= -0.5);
+}
+
+// Isto sto i stepRide, samo nad kolonama
+static void stepTrainColumns(TrainWorld& world, const TrackProfile& profile, const TrainStep& c,
+    int begin, int end)
+{
+    const uint8_t ACCELERATING = (uint8_t)RideState::ACCELERATING;
+    const uint8_t RUNNING = (uint8_t)RideState::RUNNING;
+    const uint8_t STOPPING = (uint8_t)RideState::STOPPING_SICK;
+    const uint8_t PAUSED = (uint8_t)RideState::PAUSED_SICK;
+    const uint8_t RETURNING = (uint8_t)RideState::RETURNING;
+
+    const ProfileSample* samples = profile.samples.data();
+    const uint64_t profileSize = (uint64_t)profile.size;
+
+    for (int i = begin; i < end; ++i) {
+        const TrackPhase ph = world.phase[i];
+        const uint8_t oldState = world.state[i];
+        uint8_t s = oldState;
+        float v = world.speed[i];
+        double distance = 0.0;
+
+        if (s == ACCELERATING) {
+            v += c.startStep;
+            if (v > c.targetSpeed) v = c.targetSpeed;
+            distance = v * c.dt;
+            if (v >= c.runningSpeed) s = RUNNING;
+        }
+        else if (s == RUNNING) {
+            // nagib - kao sampleProfile
+            const uint64_t scaled = (uint64_t)(uint32_t)ph * profileSize;
+            const uint64_t k = scaled >> 32;
+            const float alpha = (float)((double)(uint32_t)scaled / PHASE_ONE_LAP);
+            const float slope = samples[k].slope + (samples[k + 1].slope - samples[k].slope) * alpha;
+
+            // v + downhill * (-slope) * dt == v - downhill * slope * dt, do bita
+            v -= (slope > 0.0f ? c.uphillBrake : c.downhillAccel) * slope * c.dtf;
+            const float flatness = 1.0f - std::min(1.0f, std::fabs(slope) * 4);
+            v += (c.targetSpeed - v) * flatness * c.friction * c.dtf;
+            if (v < c.minSpeed) v = c.minSpeed;
+            if (v > c.maxSpeed) v = c.maxSpeed;
+            distance = v * c.dt;
+        }
+        else if (s == STOPPING) {
+            v -= c.brakeStep;
+            if (v <= 0.0f) {
+                v = 0.0f;
+                s = PAUSED;
+                world.pauseTimer[i] = 0.0;
+            }
+            else {
+                distance = v * c.dt;
+            }
+        }
+        else if (s == RETURNING) {
+            distance = world.returningForward[i] ? c.returnStep : -c.returnStep;
+        }
+
+        const TrackPhase np = ph + (TrackPhase)roundStep(distance / c.length * PHASE_ONE_LAP);
+
+        if (s == PAUSED) {
+            world.pauseTimer[i] += c.dt;
+            if (world.pauseTimer[i] >= PAUSE_DURATION) {
+                // izaberi smer koji je kraci do pocetka
+                const double distBack = phaseFraction(np);
+                world.returningForward[i] = (1.0 - distBack < distBack) ? 1 : 0;
+                s = RETURNING;
+            }
+        }
+
+        world.prevPhase[i] = ph;
+        world.phase[i] = np;
+        world.speed[i] = v;
+        world.state[i] = s;
+
+        // povratak na start (kao finishReturnToStart)
+        if ((oldState == RUNNING || oldState == RETURNING) && phaseLaps(np) != phaseLaps(ph)) {
+            world.phase[i] = 0;
+            world.prevPhase[i] = 0;
+            world.speed[i] = 0.0f;
+            world.belted[i] = 0;
+            world.sick[i] = 0;
+            world.sickSeat[i] = -1;
+            world.clearing[i] = 1;
+            world.state[i] = (uint8_t)RideState::BOARDING;
+            ++world.finishedRides[i];
+        }
+    }
+}
+
+void stepTrainRange(TrainWorld& world, const TrackProfile& profile, const RideParams& params, double dt,
+    int begin, int end)
+{
+    if (profile.totalLength <= 0.0f || begin >= end) return;
+    stepTrainColumns(world, profile, makeTrainStep(profile, params, dt), begin, end);
+}
+
+void stepTrains(TrainWorld& world, const TrackProfile& profile, const RideParams& params, double dt,
+    int numThreads)
+{
+    const int blocks = (world.count + TRAIN_BLOCK - 1) / TRAIN_BLOCK;
+    if (numThreads == 1 || blocks <= 1) {
+        stepTrainRange(world, profile, params, dt, 0, world.count);
+        return;
+    }
+    parallelForStealing(blocks, numThreads, [&](int block, int) {
+        stepTrainRange(world, profile, params, dt, block * TRAIN_BLOCK,
+            std::min(world.count, (block + 1) * TRAIN_BLOCK));
+    });
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Ride.h"
+
+#include <cstdint>
+#include <vector>
+
+// ================== Vise vozova (kolone umesto struktura) ==================
+// Isto stanje kao Ride, ali svako polje je jedan niz za sve vozove, pa korak ide jednom
+// petljom kroz susedne elemente; po vozu se racuna samo njegovo stanje. Sedista su bitovi:
+// bit i = sediste i, pa povratak na start samo brise bitove pojaseva i muke.
+//
+// Ulazi (putnici, pojasevi, start, muka) su retki: loadTrain / storeTrain prepisuju jedan voz
+// u Ride i nazad, pa vaze ista pravila kao u Ride.cpp.
+
+struct TrainWorld {
+    int count = 0;
+
+    std::vector<TrackPhase> phase;
+    std::vector<TrackPhase> prevPhase;
+    std::vector<float>      speed;
+    std::vector<double>     pauseTimer;
+    std::vector<uint8_t>    state;              // RideState
+    std::vector<uint8_t>    returningForward;
+    std::vector<uint8_t>    clearing;           // posle povratka klik izbacuje putnika
+    std::vector<uint8_t>    present;            // bitovi sedista
+    std::vector<uint8_t>    belted;
+    std::vector<uint8_t>    sick;
+    std::vector<int8_t>     sickSeat;           // -1 = niko
+    std::vector<int32_t>    finishedRides;
+};
+
+// Dodaje "n" vozova na startu (BOARDING, prazni); vraca indeks prvog
+int addTrains(TrainWorld& world, int n);
+
+Ride loadTrain(const TrainWorld& world, int train);
+void storeTrain(TrainWorld& world, int train, const Ride& ride);
+
+// Korak vozova [begin, end) - isti rezultat kao stepRide za svaki voz
+void stepTrainRange(TrainWorld& world, const TrackProfile& profile, const RideParams& params, double dt,
+    int begin, int end);
+
+// Svi vozovi; numThreads > 1 (0 = sva jezgra) deli ih na blokove od TRAIN_BLOCK
+const int TRAIN_BLOCK = 4096;
+void stepTrains(TrainWorld& world, const TrackProfile& profile, const RideParams& params, double dt,
+    int numThreads = 1);
@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ================== Paralelno izvrsavanje sa kradjom posla ==================
+// Za poslove nejednake duzine (simulacije voznje): svaka nit dobije svoj deo indeksa i uzima
+// ih redom od pocetka. Kad ostane bez posla, uzme drugu polovinu najveceg preostalog dela
+// neke druge niti. Brave se zakljucavaju jednom po poslu, a posao traje milisekundama.
+//
+// body(index, worker): worker je 0 .. numThreads-1, za podatke koji pripadaju niti.
+
+struct StealRange {
+    std::mutex lock;
+    int begin = 0;
+    int end = 0;
+};
+
+inline int stealingThreadCount(int n, int numThreads)
+{
+    if (numThreads <= 0) numThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    return std::max(1, std::min(numThreads, n));
+}
+
+template <class Body>
+void parallelForStealing(int n, int numThreads, Body body)
+{
+    numThreads = stealingThreadCount(n, numThreads);
+    if (numThreads <= 1) {
+        for (int i = 0; i < n; ++i)
+            body(i, 0);
+        return;
+    }
+
+    std::vector<StealRange> ranges(numThreads);
+    for (int k = 0; k < numThreads; ++k) {
+        ranges[k].begin = (int)((long long)n * k / numThreads);
+        ranges[k].end = (int)((long long)n * (k + 1) / numThreads);
+    }
+
+    auto worker = [&](int self) {
+        StealRange& own = ranges[self];
+        for (;;) {
+            int index = -1;
+            {
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (own.begin < own.end) index = own.begin++;
+            }
+            if (index >= 0) {
+                body(index, self);
+                continue;
+            }
+
+            // krade: najveci preostali deo, uzima drugu polovinu
+            int victim = -1, most = 0;
+            for (int k = 0; k < numThreads; ++k) {
+                if (k == self) continue;
+                std::lock_guard<std::mutex> guard(ranges[k].lock);
+                if (ranges[k].end - ranges[k].begin > most) {
+                    most = ranges[k].end - ranges[k].begin;
+                    victim = k;
+                }
+            }
+            if (victim < 0) return;   // svi delovi su prazni - nista novo ne nastaje
+
+            int first, last;
+            {
+                std::lock_guard<std::mutex> guard(ranges[victim].lock);
+                const int left = ranges[victim].end - ranges[victim].begin;
+                if (left <= 0) continue;   // neko je bio brzi
+                last = ranges[victim].end;
+                first = last - (left + 1) / 2;
+                ranges[victim].end = first;
+            }
+            std::lock_guard<std::mutex> guard(own.lock);
+            own.begin = first;
+            own.end = last;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads - 1);
+    for (int k = 1; k < numThreads; ++k)
+        workers.emplace_back(worker, k);
+    worker(0);
+    for (std::thread& w : workers)
+        w.join();
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+// sine iz SoA staze (uploadTrack): x i y su dva posebna niza u istom VBO
+layout(location = 0) in float inX;
+layout(location = 1) in float inY;
+
+uniform vec2 uPos;     // translacija (leva / desna sina)
+uniform vec3 uColor;
+
+out vec3 vColor;
+out vec2 vWorldPos;
+
+void main()
+{
+    vec2 pos = vec2(inX, inY) + uPos;
+
+    vWorldPos = pos;
+    vColor    = uColor;
+
+    gl_Position = vec4(pos, 0.0, 1.0);
+}
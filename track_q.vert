@@ -0,0 +1,25 @@
+#version 330 core
+
+// sine iz sabijene staze (TrackQuant): 16-bitni pomaci od ishodista dela staze
+layout(location = 0) in float inDx;   // GL_SHORT bez normalizacije -> broj koraka
+layout(location = 1) in float inDy;
+
+uniform samplerBuffer uChunks;     // po delu: ishodiste x, y i korak
+uniform int   uChunkPoints;        // tacaka po delu (QUANT_CHUNK_POINTS)
+uniform vec2  uPos;                // translacija (leva / desna sina)
+uniform vec3  uColor;
+
+out vec3 vColor;
+out vec2 vWorldPos;
+
+void main()
+{
+    // gl_VertexID je indeks tacke i za glDrawElements (nivoi detalja)
+    vec4 chunk = texelFetch(uChunks, gl_VertexID / uChunkPoints);
+    vec2 pos = chunk.xy + vec2(inDx, inDy) * chunk.z + uPos;
+
+    vWorldPos = pos;
+    vColor    = uColor;
+
+    gl_Position = vec4(pos, 0.0, 1.0);
+}